@@ -0,0 +1,43 @@
+# Copyright (c) 2026, CNRS
+#
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#   list of conditions and the following disclaimer.
+#
+# 1. Redistributions in binary form must reproduce the above copyright notice,
+#   this list of conditions and the following disclaimer in the documentation
+#   and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# .rst: hpp_util_add_benchmark(NAME SOURCES...)
+#
+# Add an executable NAME running the benchmarks defined with HPP_BENCHMARK in
+# SOURCES. The main function is generated, so that SOURCES only contain the
+# benchmarks. Run the executable with --help for its options.
+function(HPP_UTIL_ADD_BENCHMARK NAME)
+  set(_main ${CMAKE_CURRENT_BINARY_DIR}/${NAME}-main.cc)
+  # Only touch the generated file when it changes, to avoid rebuilds.
+  file(WRITE ${_main}.in
+       "#include <hpp/util/benchmark.hh>\n\nHPP_BENCHMARK_MAIN()\n")
+  configure_file(${_main}.in ${_main} COPYONLY)
+
+  add_executable(${NAME} ${ARGN} ${_main})
+  if(TARGET hpp-util::hpp-util)
+    target_link_libraries(${NAME} PRIVATE hpp-util::hpp-util)
+  else()
+    target_link_libraries(${NAME} PRIVATE hpp-util)
+  endif()
+endfunction(HPP_UTIL_ADD_BENCHMARK)
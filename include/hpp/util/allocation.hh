@@ -0,0 +1,117 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_ALLOCATION_HH
+#define HPP_UTIL_ALLOCATION_HH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <hpp/util/config.hh>
+
+namespace hpp {
+namespace debug {
+/// \brief Heap allocations of a thread.
+struct AllocationCounts {
+  /// Number of calls to \c operator \c new.
+  std::uint64_t allocations;
+  /// Number of calls to \c operator \c delete with a non NULL pointer.
+  std::uint64_t frees;
+  /// Number of bytes requested to \c operator \c new.
+  std::uint64_t bytes;
+
+  AllocationCounts operator-(const AllocationCounts& other) const {
+    return AllocationCounts{allocations - other.allocations,
+                            frees - other.frees, bytes - other.bytes};
+  }
+  AllocationCounts& operator+=(const AllocationCounts& other) {
+    allocations += other.allocations;
+    frees += other.frees;
+    bytes += other.bytes;
+    return *this;
+  }
+};
+
+/// \brief Functions of the library counting the heap allocations.
+///
+/// The library \c hpp-util-alloc replaces the global \c operator \c new and
+/// \c operator \c delete and registers itself when it is loaded. Link the
+/// executable with it, or preload it with \c LD_PRELOAD, to enable the
+/// allocation tracking. Without it, the allocations are not counted.
+///
+/// Each thread counts its allocations only while it is inside a tracking
+/// scope, so that the cost of an allocation outside of these scopes is a
+/// single test of a thread local variable. The over-aligned allocations of
+/// C++17 are not counted.
+struct AllocationTracker {
+  /// Enter a tracking scope in the calling thread.
+  void (*enter)();
+  /// Leave a tracking scope in the calling thread.
+  void (*leave)();
+  /// Counts of the calling thread.
+  AllocationCounts (*read)();
+};
+
+/// \cond
+namespace internal {
+HPP_UTIL_DLLAPI extern std::atomic<const AllocationTracker*>
+    allocationTracker;
+}  // namespace internal
+/// \endcond
+
+/// \brief Register the allocation tracker. Called by \c hpp-util-alloc.
+HPP_UTIL_DLLAPI void setAllocationTracker(const AllocationTracker* tracker);
+
+/// \brief Whether the allocations can be counted, i.e. whether
+///        \c hpp-util-alloc is loaded.
+inline bool isAllocationTrackingAvailable() {
+  return internal::allocationTracker.load(std::memory_order_acquire) != NULL;
+}
+
+/// \brief Count the heap allocations of the calling thread during the
+///        lifetime of the object.
+///
+/// All the counts are 0 if the allocation tracking is not available.
+class HPP_UTIL_DLLAPI AllocScope {
+ public:
+  AllocScope();
+  ~AllocScope();
+
+  /// \brief Allocations since the construction.
+  AllocationCounts counts() const;
+
+ private:
+  AllocScope(const AllocScope&) = delete;
+  AllocScope& operator=(const AllocScope&) = delete;
+
+  const AllocationTracker* tracker_;
+  AllocationCounts start_;
+};
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_ALLOCATION_HH
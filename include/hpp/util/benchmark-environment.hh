@@ -0,0 +1,81 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_BENCHMARK_ENVIRONMENT_HH
+#define HPP_UTIL_BENCHMARK_ENVIRONMENT_HH
+
+#include <hpp/util/config.hh>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace hpp {
+namespace debug {
+/// \brief State of the machine that makes benchmark measurements noisy.
+///
+/// It is read from the \c /sys and \c /proc file systems of Linux. On other
+/// platforms, or when a file is missing, the corresponding field is unknown.
+struct HPP_UTIL_DLLAPI BenchmarkEnvironment {
+  /// Online processors.
+  std::vector<int> cpus;
+  /// Frequency scaling governor of each online processor, empty if unknown.
+  std::vector<std::string> governors;
+  /// 1 if the turbo boost is enabled, 0 if it is disabled, -1 if unknown.
+  int turbo;
+  /// Load averages over 1, 5 and 15 minutes, negative if unknown.
+  double load[3];
+  /// Processors isolated from the scheduler, see the \c isolcpus kernel
+  /// parameter.
+  std::vector<int> isolated;
+
+  BenchmarkEnvironment();
+
+  /// \brief Read the state of the machine.
+  /// \param root directory under which \c /sys and \c /proc are searched,
+  ///        to read a copy of these file systems.
+  static BenchmarkEnvironment read(const std::string& root = "");
+
+  /// \brief Descriptions of the conditions that make measurements noisy:
+  ///        a governor other than \c performance, the turbo boost, a load
+  ///        average per online processor above \c maxLoadPerCpu and, if
+  ///        \c cpu is not negative and some processors are isolated, a
+  ///        processor \c cpu that is not.
+  std::vector<std::string> problems(double maxLoadPerCpu,
+                                    int cpu = -1) const;
+};
+
+/// \brief Write the environment, one field per line.
+HPP_UTIL_DLLAPI std::ostream& operator<<(std::ostream& os,
+                                         const BenchmarkEnvironment& env);
+
+/// \brief Parse a list of processors such as <code>0-3,8,10-11</code>.
+/// \throw std::invalid_argument if the list is not valid.
+HPP_UTIL_DLLAPI std::vector<int> parseCpuList(const std::string& list);
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_BENCHMARK_ENVIRONMENT_HH
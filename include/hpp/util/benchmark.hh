@@ -0,0 +1,249 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_BENCHMARK_HH
+#define HPP_UTIL_BENCHMARK_HH
+
+#include <cstddef>
+#include <hpp/util/benchmark-environment.hh>
+#include <hpp/util/config.hh>
+#include <hpp/util/timer.hh>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace hpp {
+namespace debug {
+/// \brief Prevent the compiler from optimizing away the computation of
+///        \c value.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/// \brief Prevent the compiler from caching values in registers across this
+///        call, so that pending writes to memory are performed.
+inline void clobberMemory() {
+#if defined(__GNUC__)
+  asm volatile("" : : : "memory");
+#endif
+}
+
+/// \brief State of a benchmark, passed to the benchmarked function.
+///
+/// The benchmarked function runs the code to measure in a loop:
+/// \code
+///   HPP_BENCHMARK(projection) {
+///     Configuration_t q = setup();
+///     while (state.keepRunning()) doNotOptimize(project(q));
+///   }
+/// \endcode
+/// Only the loop is timed.
+class HPP_UTIL_DLLAPI BenchmarkState {
+ public:
+  explicit BenchmarkState(std::size_t iterations);
+
+  /// \brief Whether the loop should run another iteration.
+  bool keepRunning() {
+    if (remaining_ > 0) {
+      --remaining_;
+      return true;
+    }
+    return startOrStop();
+  }
+
+  /// \brief Number of iterations of the loop.
+  std::size_t iterations() const { return iterations_; }
+
+  /// \brief Exclude the following code from the measurement, until
+  ///        resumeTiming.
+  void pauseTiming();
+  void resumeTiming();
+
+  /// \brief Time spent in the loop, in seconds, without the pauses.
+  double elapsed() const;
+
+ private:
+  bool startOrStop();
+
+  std::size_t iterations_, remaining_;
+  bool started_;
+  Timer timer_, pause_;
+  double paused_;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState&);
+
+/// \brief Register a benchmark run by runBenchmarks.
+/// \return true, so that it can initialize a static variable.
+/// \sa HPP_BENCHMARK
+HPP_UTIL_DLLAPI bool registerBenchmark(const char* name, BenchmarkFunction f);
+
+struct HPP_UTIL_DLLAPI BenchmarkOptions {
+  /// Minimal duration of a sample, in seconds. The number of iterations of
+  /// each sample is chosen to reach it.
+  double minTime;
+  /// Number of samples.
+  std::size_t repetitions;
+  /// Duration, in seconds, of the runs discarded before the samples.
+  double warmupTime;
+  /// Processor to which the thread is pinned, -1 to not pin it.
+  int cpu;
+  /// Only the benchmarks whose name contains this string are run.
+  std::string filter;
+  /// What runBenchmarks does when the environment is noisy, see
+  /// BenchmarkEnvironment::problems.
+  enum NoisePolicy { IgnoreNoise, WarnOnNoise, RefuseNoise } noise;
+  /// Load average per online processor above which the environment is
+  /// noisy.
+  double maxLoadPerCpu;
+
+  BenchmarkOptions();
+};
+
+struct HPP_UTIL_DLLAPI BenchmarkResult {
+  std::string name;
+  /// Number of iterations of each sample.
+  std::size_t iterations;
+  /// Time per iteration of each sample, in seconds.
+  std::vector<double> samples;
+  double median, mad, mean, min, max;
+};
+
+/// \brief Run one benchmark.
+HPP_UTIL_DLLAPI BenchmarkResult runBenchmark(const std::string& name,
+                                             BenchmarkFunction f,
+                                             const BenchmarkOptions& options);
+
+/// \brief Run the registered benchmarks matching the filter, in the order
+///        of their registration.
+///
+/// The calling thread is pinned first if requested. The environment is
+/// checked according to BenchmarkOptions::noise: the problems are written
+/// to \c std::cerr or, if the run is refused, thrown as a
+/// \c std::runtime_error.
+HPP_UTIL_DLLAPI std::vector<BenchmarkResult> runBenchmarks(
+    const BenchmarkOptions& options);
+
+/// \brief Pin the calling thread to a processor.
+/// \return false if it failed or is not supported on this platform.
+HPP_UTIL_DLLAPI bool pinThreadToCpu(int cpu);
+
+/// \brief Write a table of the results.
+HPP_UTIL_DLLAPI std::ostream& printBenchmarks(
+    std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+/// \brief Write the results, including the samples, as JSON.
+HPP_UTIL_DLLAPI std::ostream& writeBenchmarksJson(
+    std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+/// \brief Write the results, without the samples, as CSV.
+HPP_UTIL_DLLAPI std::ostream& writeBenchmarksCsv(
+    std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+/// \brief Read results written by writeBenchmarksJson.
+/// \throw std::runtime_error if the input is not valid.
+HPP_UTIL_DLLAPI std::vector<BenchmarkResult> readBenchmarksJson(
+    std::istream& is);
+
+/// \brief Comparison of the samples of a benchmark in two runs.
+struct HPP_UTIL_DLLAPI BenchmarkComparison {
+  std::string name;
+  /// Medians of the baseline and of the contender, in seconds.
+  double baseline, contender;
+  /// Relative change of the contender, i.e. the median of the ratios
+  /// <code>contender / baseline - 1</code> over all the pairs of samples.
+  double change;
+  /// Confidence interval of the change.
+  double changeLow, changeHigh;
+  /// p-value of the Mann-Whitney U test of the samples.
+  double pValue;
+
+  /// \brief Whether the difference is statistically significant at level
+  ///        \c alpha and the change is above \c threshold.
+  bool isRegression(double alpha, double threshold) const {
+    return pValue < alpha && change > threshold;
+  }
+  bool isImprovement(double alpha, double threshold) const {
+    return pValue < alpha && change < -threshold;
+  }
+};
+
+/// \brief Compare the benchmarks present in both runs, matched by name.
+/// \param confidence level of the confidence intervals of the changes.
+/// The comparisons follow the order of \c baseline.
+HPP_UTIL_DLLAPI std::vector<BenchmarkComparison> compareBenchmarks(
+    const std::vector<BenchmarkResult>& baseline,
+    const std::vector<BenchmarkResult>& contender, double confidence = 0.95);
+
+/// \brief Parse the command line, run the benchmarks and write the results.
+///
+/// Run with \c --help for the list of options.
+/// \return the exit status of the program.
+HPP_UTIL_DLLAPI int benchmarkMain(int argc, char** argv);
+}  // namespace debug
+}  // namespace hpp
+
+/// \addtogroup hpp_util_benchmark
+/// \{
+
+/// \brief Define and register a benchmark.
+///
+/// The body that follows is a function which accesses a
+/// <code>BenchmarkState& state</code>. See BenchmarkState.
+#define HPP_BENCHMARK(name)                                        \
+  namespace {                                                      \
+  struct _##name##_benchmark_ {                                    \
+    ::hpp::debug::BenchmarkState& state;                           \
+    void run();                                                    \
+    static void call(::hpp::debug::BenchmarkState& s) {            \
+      _##name##_benchmark_ benchmark = {s};                        \
+      benchmark.run();                                             \
+    }                                                              \
+  };                                                               \
+  const bool _##name##_benchmark_registered_ =                     \
+      ::hpp::debug::registerBenchmark(#name,                       \
+                                      _##name##_benchmark_::call); \
+  }                                                                \
+  void _##name##_benchmark_::run()
+
+/// \brief Define the \c main function of a benchmark executable.
+///
+/// The CMake function \c hpp_util_add_benchmark defines it.
+#define HPP_BENCHMARK_MAIN()                        \
+  int main(int argc, char** argv) {                 \
+    return ::hpp::debug::benchmarkMain(argc, argv); \
+  }
+
+/// \}
+
+#endif  // HPP_UTIL_BENCHMARK_HH
@@ -0,0 +1,199 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_BUDGET_HH
+#define HPP_UTIL_BUDGET_HH
+
+#include <chrono>
+#include <functional>
+#include <hpp/util/config.hh>
+#include <hpp/util/histogram.hh>
+#include <hpp/util/timer.hh>
+#include <hpp/util/trace.hh>
+#include <mutex>
+#include <string>
+
+namespace hpp {
+namespace debug {
+/// \brief Time budget of a section of code, and statistics of its durations
+///        and of its overruns.
+///
+/// Like the time counters, it registers itself in the registry used by
+/// dumpTimeCounters. The durations are recorded by BudgetScope. When a
+/// duration exceeds the budget, the overrun, i.e. the duration minus the
+/// budget, is recorded, the callback set by onOverrun is called and a
+/// warning may be logged, see enableOverrunLog.
+///
+/// The methods may be called concurrently.
+class HPP_UTIL_DLLAPI BudgetCounter : public TimeCounterBase {
+ public:
+  /// \brief Called with the counter and the duration, in seconds, of each
+  ///        overrun, by the thread leaving the scope.
+  typedef std::function<void(const BudgetCounter&, double)> Callback;
+
+  /// \param budget in seconds.
+  /// \throw std::invalid_argument if \c budget is not positive.
+  BudgetCounter(const std::string& name, double budget);
+  ~BudgetCounter();
+
+  /// \brief Budget, in seconds.
+  double budget() const;
+
+  /// \brief Set the budget, in seconds, of the following scopes.
+  /// \throw std::invalid_argument if \c budget is not positive.
+  void setBudget(double budget);
+
+  /// \brief Set the function called on each overrun, or none if empty.
+  void onOverrun(const Callback& callback);
+
+  /// \brief Write a warning for the overruns, at most once every
+  ///        \c interval seconds.
+  ///
+  /// The warning reports the last overrun and the number of overruns
+  /// since the previous warning.
+  void enableOverrunLog(bool enable = true, double interval = 1);
+
+  /// \brief Record a duration, in seconds.
+  void record(double duration);
+
+  unsigned long count() const;
+  double totalTime() const;
+  /// \brief Number of durations exceeding the budget.
+  unsigned long overruns() const;
+  /// \brief Sum of the overruns, in seconds.
+  double totalOverrun() const;
+  /// \brief Largest overrun, in seconds, 0 if there was none.
+  double maxOverrun() const;
+
+  /// \brief Duration below which \c p percent of the durations are.
+  double percentile(double p) const;
+
+  void reset();
+
+  Snapshot snapshot() const;
+  bool isThreadSafe() const { return true; }
+
+  std::unique_ptr<Histogram> copyHistogram() const;
+
+  std::ostream& print(std::ostream& os) const;
+
+ private:
+  BudgetCounter(const BudgetCounter&) = delete;
+  BudgetCounter& operator=(const BudgetCounter&) = delete;
+
+  /// Protects all the members below.
+  mutable std::mutex mutex_;
+  double budget_;
+  unsigned long count_, overruns_;
+  double total_, min_, max_, totalOverrun_, maxOverrun_;
+  Histogram durations_;
+  Callback callback_;
+  bool logEnabled_;
+  double logInterval_;
+  /// Time of the last warning and number of overruns since then.
+  Timer::time_point lastLog_;
+  unsigned long unlogged_;
+};
+
+std::ostream& operator<<(std::ostream& os, const BudgetCounter& bc);
+
+/// \brief Measure the duration of a scope against the budget of a
+///        BudgetCounter.
+///
+/// The duration, from the construction to the destruction, is recorded in
+/// the counter. The algorithms running in the scope may call expired to
+/// stop early when the budget is exhausted:
+/// \code
+///   static hpp::debug::BudgetCounter replanBudget("replan", 0.01);
+///   hpp::debug::BudgetScope budget(replanBudget);
+///   while (!budget.expired() && !solved) iterate();
+/// \endcode
+/// See also HPP_BUDGET_SCOPE.
+class HPP_UTIL_DLLAPI BudgetScope {
+ public:
+  explicit BudgetScope(BudgetCounter& counter);
+  ~BudgetScope();
+
+  /// \brief Whether the budget is exhausted.
+  ///
+  /// The clock is only read every few calls, so that the cost of a call is
+  /// about a nanosecond and expired can be called in inner loops. The
+  /// number of calls between two reads adapts so that the clock is read
+  /// about every thousandth of the budget, and at most every microsecond.
+  /// Once it returned true, it always does.
+  bool expired() {
+    if (countdown_ > 1) {
+      --countdown_;
+      return false;
+    }
+    return readClock();
+  }
+
+  /// \brief Time elapsed since the construction, in seconds.
+  double elapsed() const;
+
+  /// \brief Time left before the end of the budget, in seconds, negative
+  ///        if the budget is exceeded.
+  double remaining() const;
+
+ private:
+  BudgetScope(const BudgetScope&) = delete;
+  BudgetScope& operator=(const BudgetScope&) = delete;
+
+  bool readClock();
+
+  BudgetCounter& counter_;
+  TraceScope trace_;
+  Timer timer_;
+  Timer::time_point deadline_, lastRead_;
+  Timer::clock_type::duration period_;
+  unsigned long countdown_, stride_;
+  bool expired_;
+};
+}  // namespace debug
+}  // namespace hpp
+
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \brief Declare a BudgetScope called \c name, measured by a static
+///        BudgetCounter of the same name.
+///
+/// \c budget, in seconds, is the budget of the counter when it is
+/// constructed, the first time the scope is entered.
+/// \code
+///   HPP_BUDGET_SCOPE(replan, 0.01);
+///   while (!replan.expired() && !solved) iterate();
+/// \endcode
+#define HPP_BUDGET_SCOPE(name, budget)                                   \
+  static ::hpp::debug::BudgetCounter _##name##_budgetcounter_(#name,     \
+                                                              (budget)); \
+  ::hpp::debug::BudgetScope name(_##name##_budgetcounter_)
+
+/// \}
+
+#endif  // HPP_UTIL_BUDGET_HH
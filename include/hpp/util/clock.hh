@@ -0,0 +1,131 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_CLOCK_HH
+#define HPP_UTIL_CLOCK_HH
+
+#include <chrono>
+#include <cstdint>
+#include <hpp/util/config.hh>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HPP_UTIL_HAS_TSC 1
+#endif
+
+namespace hpp {
+namespace debug {
+/// \cond
+namespace internal {
+/// \brief Conversion of time stamp counter ticks to nanoseconds.
+struct TscCalibration {
+  /// Whether the time stamp counter is invariant and calibrated.
+  bool usable;
+  std::uint64_t tscOrigin;
+  std::int64_t nsOrigin;
+  double nsPerTick;
+};
+
+/// \brief Calibration of the time stamp counter against
+///        \c std::chrono::steady_clock, performed on the first call.
+HPP_UTIL_DLLAPI const TscCalibration& tscCalibration();
+
+/// \brief Raw time stamp: ticks of the time stamp counter if it is usable,
+///        nanoseconds of \c std::chrono::steady_clock otherwise.
+///
+/// Cheaper than TscClock::now for event buffers, which convert the stamps
+/// with rawStampToNanoseconds only when they are written.
+HPP_UTIL_DLLAPI std::uint64_t rawStamp();
+
+/// \brief Time of a raw time stamp, on the time line of TscClock.
+HPP_UTIL_DLLAPI std::int64_t rawStampToNanoseconds(std::uint64_t stamp);
+}  // namespace internal
+/// \endcond
+
+/// \brief Clock reading the time stamp counter of the processor.
+///
+/// Reading the counter takes a few nanoseconds, against about 20 for
+/// \c std::chrono::steady_clock, which matters for measurements of very short
+/// sections of code. The counter is converted to nanoseconds using a
+/// calibration against \c std::chrono::steady_clock, so that both clocks
+/// share the same origin.
+///
+/// When the processor has no invariant time stamp counter, or when the
+/// environment variable <code>HPP_TSC_CLOCK</code> is set to \c 0, the clock
+/// falls back to \c std::chrono::steady_clock.
+///
+/// This class meets the requirements of the \c TrivialClock concept.
+struct TscClock {
+  typedef std::chrono::nanoseconds duration;
+  typedef duration::rep rep;
+  typedef duration::period period;
+  typedef std::chrono::time_point<TscClock> time_point;
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept {
+    const internal::TscCalibration& c = internal::tscCalibration();
+#ifdef HPP_UTIL_HAS_TSC
+    if (c.usable) {
+      // rdtscp waits for the previous instructions to complete.
+      unsigned aux;
+      std::uint64_t ticks = __rdtscp(&aux);
+      // Signed, as the counter of another core may be slightly behind the
+      // origin.
+      return time_point(
+          duration(c.nsOrigin + rep(double(std::int64_t(ticks - c.tscOrigin)) *
+                                    c.nsPerTick)));
+    }
+#endif
+    (void)c;
+    return time_point(std::chrono::duration_cast<duration>(
+        std::chrono::steady_clock::now().time_since_epoch()));
+  }
+
+  /// \brief Whether the time stamp counter is used.
+  static bool isTscUsed() { return internal::tscCalibration().usable; }
+
+  /// \brief Frequency of the time stamp counter, in Hz, 0 if not used.
+  static double tscFrequency() {
+    const internal::TscCalibration& c = internal::tscCalibration();
+    return c.usable ? 1e9 / c.nsPerTick : 0;
+  }
+};
+
+/// \brief Clock of Timer, TimeCounter, ConcurrentTimeCounter and
+///        ProfileScope.
+///
+/// This is \c std::chrono::steady_clock unless the library is built with the
+/// CMake option <code>HPP_UTIL_TSC_CLOCK</code>, which selects TscClock.
+#ifdef HPP_UTIL_TSC_CLOCK
+typedef TscClock DefaultClock;
+#else
+typedef std::chrono::steady_clock DefaultClock;
+#endif
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_CLOCK_HH
@@ -0,0 +1,79 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#ifndef HPP_UTIL_CPU_USAGE_HH
+#define HPP_UTIL_CPU_USAGE_HH
+
+#include <hpp/util/config.hh>
+
+namespace hpp {
+namespace debug {
+/// \brief CPU time and context switches of the calling thread, and CPU time
+///        of the process.
+///
+/// Comparing the CPU time of the thread to the wall time of a measurement
+/// tells whether the thread was computing or waiting, for instance because
+/// it was descheduled on an oversubscribed machine.
+struct HPP_UTIL_DLLAPI CpuUsage {
+  /// CPU time of the calling thread, in seconds.
+  double threadTime;
+  /// CPU time of all the threads of the process, in seconds.
+  double processTime;
+  /// Context switches of the calling thread because it waited for a
+  /// resource.
+  long voluntarySwitches;
+  /// Context switches of the calling thread because it was preempted.
+  long involuntarySwitches;
+
+  CpuUsage operator-(const CpuUsage& other) const {
+    return CpuUsage{threadTime - other.threadTime,
+                    processTime - other.processTime,
+                    voluntarySwitches - other.voluntarySwitches,
+                    involuntarySwitches - other.involuntarySwitches};
+  }
+  CpuUsage& operator+=(const CpuUsage& other) {
+    threadTime += other.threadTime;
+    processTime += other.processTime;
+    voluntarySwitches += other.voluntarySwitches;
+    involuntarySwitches += other.involuntarySwitches;
+    return *this;
+  }
+
+  /// \brief Read the usage of the calling thread.
+  ///
+  /// The CPU times are read with \c clock_gettime and the clocks
+  /// \c CLOCK_THREAD_CPUTIME_ID and \c CLOCK_PROCESS_CPUTIME_ID, the context
+  /// switches with <code>getrusage(RUSAGE_THREAD)</code>. This costs three
+  /// system calls, or less with the vDSO.
+  /// \return false, and zeros, if this is not supported by the platform.
+  static bool read(CpuUsage& usage);
+};
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_CPU_USAGE_HH
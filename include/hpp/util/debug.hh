@@ -33,9 +33,13 @@
 
 #ifndef HPP_UTIL_DEBUG_HH
 #define HPP_UTIL_DEBUG_HH
+#include <atomic>
+#include <cstddef>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <hpp/util/config.hh>
+#include <hpp/util/format.hh>
 #include <hpp/util/indent.hh>
 #include <ostream>
 #include <sstream>
@@ -104,8 +108,37 @@ HPP_UTIL_DLLAPI int getVerbosityLevel();
 /// \brief Set the verbosity level.
 HPP_UTIL_DLLAPI void setVerbosityLevel(int level);
 
-HPP_UTIL_DLLAPI bool isBenchmarkEnabled();
+/// \cond
+namespace internal {
+/// State of the benchmark channel. It is constant-initialized to
+/// BenchmarkUnknown, so that it is usable during the static initialization,
+/// and the environment variable is read by the first query.
+enum BenchmarkState { BenchmarkUnknown, BenchmarkDisabled, BenchmarkEnabled };
+extern HPP_UTIL_DLLAPI std::atomic<int> benchmarkState;
+
+/// \brief Set the state from the environment variable, unless
+///        enableBenchmark was called first.
+/// \return the state.
+HPP_UTIL_DLLAPI int initBenchmarkState();
+}  // namespace internal
+/// \endcond
+
+/// \brief Whether the benchmark channel is enabled.
+///
+/// With \c HPP_ENABLE_RUNTIME_BENCHMARK, this also switches the benchmark
+/// macros on and off. See \ref HPP_BENCHMARK_IS_ENABLED.
+inline bool isBenchmarkEnabled() {
+  int state = internal::benchmarkState.load(std::memory_order_relaxed);
+  if (state == internal::BenchmarkUnknown)
+    state = internal::initBenchmarkState();
+  return state == internal::BenchmarkEnabled;
+}
 
+/// \brief Enable or disable the benchmark channel.
+///
+/// It can be called at any time from any thread. At startup, the channel is
+/// enabled if the environment variable <code>HPP_LOGGINGLEVEL</code>
+/// contains \c benchmark, as in <code>HPP_LOGGINGLEVEL=30,benchmark</code>.
 HPP_UTIL_DLLAPI void enableBenchmark(bool enable);
 
 inline bool isChannelEnabled(int channel) {
@@ -113,6 +146,74 @@ inline bool isChannelEnabled(int channel) {
   return getVerbosityLevel() >= channel;
 }
 
+/// \brief Per-thread logging context.
+///
+/// Contexts form a stack local to each thread: constructing a LogContext
+/// pushes it and destroying it pops it. When a record is written, the
+/// outputs render the active stack in the prefix, for instance
+/// <code>[planner-3 request=42]</code>: the name is the one of the innermost
+/// named context, the tags are those of all the contexts of the stack.
+///
+/// Only pointers and integers are stored, so that pushing a context costs a
+/// few stores and no formatting. Strings given to the constructor and to
+/// tag() are not copied and must outlive the context.
+/// \code
+///   hpp::debug::LogContext context("planner-3");
+///   context.tag("request", requestId);
+///   hppDout(info, "solved");
+/// \endcode
+class HPP_UTIL_DLLAPI LogContext {
+ public:
+  /// Maximal number of tags of one context. Extra tags are ignored.
+  static constexpr std::size_t maxTags = 4;
+
+  explicit LogContext(const char* name = NULL)
+      : parent_(current_), name_(name), nTags_(0) {
+    current_ = this;
+  }
+
+  ~LogContext() { current_ = parent_; }
+
+  LogContext& tag(const char* key, const char* value) {
+    if (nTags_ < maxTags) tags_[nTags_++] = Tag{key, value, 0};
+    return *this;
+  }
+
+  LogContext& tag(const char* key, long value) {
+    if (nTags_ < maxTags) tags_[nTags_++] = Tag{key, NULL, value};
+    return *this;
+  }
+
+  /// \brief Innermost context of the calling thread, NULL if none.
+  static const LogContext* current() { return current_; }
+
+  const LogContext* parent() const { return parent_; }
+
+  const char* name() const { return name_; }
+
+  /// \brief Write the whole stack ending with this context.
+  std::ostream& print(std::ostream& os) const;
+
+ private:
+  struct Tag {
+    const char* key;
+    const char* str;
+    long value;
+  };
+
+  LogContext(const LogContext&) = delete;
+  LogContext& operator=(const LogContext&) = delete;
+
+  std::ostream& printTags(std::ostream& os, bool& first) const;
+
+  const LogContext* parent_;
+  const char* name_;
+  Tag tags_[maxTags];
+  std::size_t nTags_;
+
+  static thread_local const LogContext* current_;
+};
+
 /// \brief Debugging output.
 ///
 /// Represents a debugging output, i.e. an output stream
@@ -182,10 +283,17 @@ class HPP_UTIL_DLLAPI JournalOutput : public Output {
 
   std::string getFilename() const;
 
+  /// \brief Set the function writing the header of the file, when it is
+  ///        opened by the first write.
+  void setHeader(std::function<void(std::ostream&)> header);
+
  private:
+  void open();
+
   std::string filename;
   std::string lastFunction;
   std::ofstream stream;
+  std::function<void(std::ostream&)> header;
 };
 
 /// \brief Logging in console (std::cerr).
@@ -210,6 +318,8 @@ class HPP_UTIL_DLLAPI Logging {
   /// \brief Logs to main journal file (i.e. journal.XXX.log).
   JournalOutput journal;
   /// \brief Logs to benchmark journal file (i.e. benchmark.XXX.log).
+  ///
+  /// Its header describes the BenchmarkEnvironment.
   JournalOutput benchmarkJournal;
 
   /// \brief Fatal problems channel.
@@ -232,11 +342,61 @@ class HPP_UTIL_DLLAPI Logging {
 
 namespace hpp {
 namespace debug {
-/// \brief Benchmark information.
-extern HPP_UTIL_DLLAPI Logging logging;
+/// \brief Channels and outputs used by the logging macros.
+///
+/// The instance is built on first use, so that it can be used from static
+/// constructors of other libraries. The journal files are created on the
+/// first record written to them.
+HPP_UTIL_DLLAPI Logging& logging();
 }  // end of namespace debug
 }  // end of namespace hpp
 
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \def HPP_BENCHMARK_IS_ENABLED()
+/// \brief Whether the benchmark macros measure.
+///
+/// The benchmark macros, such as hppStartBenchmark, HPP_SCOPE_TIMECOUNTER
+/// and HPP_PROFILE_SCOPE, have three modes:
+/// \li by default, they are compiled out,
+/// \li with \c HPP_ENABLE_BENCHMARK, they always measure,
+/// \li with \c HPP_ENABLE_RUNTIME_BENCHMARK, they are compiled in but only
+///     measure when hpp::debug::isBenchmarkEnabled returns true, so that
+///     they can be switched on by hpp::debug::enableBenchmark on a running
+///     program. When disabled, they cost a relaxed load and a branch, and
+///     do not read the clock.
+
+#ifdef HPP_ENABLE_BENCHMARK
+#define HPP_BENCHMARK_IS_ENABLED() true
+#elif defined(HPP_ENABLE_RUNTIME_BENCHMARK)
+#define HPP_BENCHMARK_IS_ENABLED() ::hpp::debug::isBenchmarkEnabled()
+#endif
+
+/// \}
+
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \brief Write to \c channel the formatting of the arguments according to
+/// the string literal that comes first, whether HPP_DEBUG is defined or not.
+///
+/// This is hppDoutf for the messages which matter in release builds, such
+/// as the errors of the background threads.
+#define hppLogf(channel, ...)                                          \
+  do {                                                                 \
+    using namespace ::hpp::debug;                                      \
+    if (isChannelEnabled(verbosityLevel::channel)) {                   \
+      ::hpp::debug::format::Buffer __buf;                              \
+      HPP_FORMAT_TO(__buf.str(), __VA_ARGS__);                         \
+      __buf.str() += '\n';                                             \
+      logging().channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, \
+                            __buf.str());                              \
+    }                                                                  \
+  } while (0)
+
+/// \}
+
 #ifdef HPP_DEBUG
 
 /// \addtogroup hpp_util_debugging
@@ -263,29 +423,53 @@ extern HPP_UTIL_DLLAPI Logging logging;
 /// \param channel one of \em error, \em warning, \em notice, \em info or \em
 /// benchmark. \param data a statement that can be \c << to a \c
 /// std::stringstream.
-#define hppDout(channel, data)                                              \
-  do {                                                                      \
-    using namespace hpp;                                                    \
-    using namespace ::hpp::debug;                                           \
-    if (isChannelEnabled(verbosityLevel::channel)) {                        \
-      std::stringstream __ss;                                               \
-      __ss << data << iendl;                                                \
-      logging.channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
-    }                                                                       \
+#define hppDout(channel, data)                                                \
+  do {                                                                        \
+    using namespace hpp;                                                      \
+    using namespace ::hpp::debug;                                             \
+    if (isChannelEnabled(verbosityLevel::channel)) {                          \
+      std::stringstream __ss;                                                 \
+      __ss << data << iendl;                                                  \
+      logging().channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
+    }                                                                         \
   } while (0)
 
+/// \brief Write to \c channel the formatting of the arguments according to
+/// the string literal that comes first when HPP_DEBUG is defined.
+///
+/// Contrary to hppDout, numbers are written without iostreams, in a buffer
+/// reused by the thread. The format string is checked at compile time, see
+/// hpp::debug::format for its syntax, even when HPP_DEBUG is not defined.
+/// \code
+///   hppDoutf(info, "solved in {} iterations, cost {:.3f}", n, c);
+/// \endcode
+#define hppDoutf(channel, ...) hppLogf(channel, __VA_ARGS__)
+
 /// \brief Write \c data to \c channel and exit the program.
 /// \param channel one of \em error, \em warning, \em notice, \em info or \em
 /// benchmark. \param data a statement that can be \c << to a \c
 /// std::stringstream.
-#define hppDoutFatal(channel, data)                                       \
-  do {                                                                    \
-    using namespace hpp;                                                  \
-    using namespace ::hpp::debug;                                         \
-    std::stringstream __ss;                                               \
-    __ss << data << iendl;                                                \
-    logging.channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
-    ::std::exit(EXIT_FAILURE);                                            \
+#define hppDoutFatal(channel, data)                                         \
+  do {                                                                      \
+    using namespace hpp;                                                    \
+    using namespace ::hpp::debug;                                           \
+    std::stringstream __ss;                                                 \
+    __ss << data << iendl;                                                  \
+    logging().channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
+    ::std::exit(EXIT_FAILURE);                                              \
+  } while (1)
+
+/// \brief Write to \c channel the formatting of the arguments and exit the
+/// program.
+#define hppDoutFatalf(channel, ...)                                  \
+  do {                                                               \
+    using namespace ::hpp::debug;                                    \
+    ::hpp::debug::format::Buffer __buf;                              \
+    HPP_FORMAT_TO(__buf.str(), __VA_ARGS__);                         \
+    __buf.str() += '\n';                                             \
+    logging().channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, \
+                          __buf.str());                              \
+    ::std::exit(EXIT_FAILURE);                                       \
   } while (1)
 
 /// \}
@@ -305,6 +489,22 @@ extern HPP_UTIL_DLLAPI Logging logging;
     ::std::cerr << data << iendl;   \
     ::std::exit(EXIT_FAILURE);      \
   } while (1)
+// The formatting is compiled, so that the format string is checked, but
+// never run.
+#define hppDoutf(channel, ...)                 \
+  do {                                         \
+    if (false) {                               \
+      ::hpp::debug::format::Buffer __buf;      \
+      HPP_FORMAT_TO(__buf.str(), __VA_ARGS__); \
+    }                                          \
+  } while (0)
+#define hppDoutFatalf(channel, ...)            \
+  do {                                         \
+    ::hpp::debug::format::Buffer __buf;        \
+    HPP_FORMAT_TO(__buf.str(), __VA_ARGS__);   \
+    ::std::cerr << __buf.str() << ::std::endl; \
+    ::std::exit(EXIT_FAILURE);                 \
+  } while (1)
 
 #endif  // HPP_DEBUG
 
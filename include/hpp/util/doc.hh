@@ -51,6 +51,15 @@
 
    \defgroup hpp_util_logging Macros for logging
 
+   \defgroup hpp_util_benchmark Macros for micro-benchmarks
+
+   Benchmarks are defined with HPP_BENCHMARK and run by the \c main function
+   defined by HPP_BENCHMARK_MAIN. In CMake, after
+   <code>find_package(hpp-util)</code>, the executable is added by
+   \code
+     hpp_util_add_benchmark(my-benchmarks my-benchmarks.cc)
+   \endcode
+
    \defgroup hpp_util_exceptions Macros for \c std::exception
 
    It eases throwing exceptions built from string stream. You can use
@@ -0,0 +1,171 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_FLIGHT_RECORDER_HH
+#define HPP_UTIL_FLIGHT_RECORDER_HH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <hpp/util/config.hh>
+#include <hpp/util/profiler.hh>
+#include <iosfwd>
+#include <string>
+
+namespace hpp {
+namespace debug {
+/// \cond
+namespace internal {
+enum FlightEventType { FlightBegin = 1, FlightEnd = 2, FlightInstant = 3 };
+
+extern HPP_UTIL_DLLAPI std::atomic<bool> flightTriggersArmed;
+
+/// \brief Append an event to the ring of the calling thread.
+/// \return the time stamp of the event.
+HPP_UTIL_DLLAPI std::uint64_t flightRecord(const ScopeId& id,
+                                           FlightEventType type,
+                                           std::uint64_t payload);
+
+HPP_UTIL_DLLAPI void checkFlightTrigger(const ScopeId& id,
+                                        std::uint64_t duration);
+}  // namespace internal
+/// \endcond
+
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \brief Record the beginning and the end of a scope in the flight recorder.
+///
+/// The flight recorder is always on: each thread writes its events in a ring
+/// of fixed size, which keeps the most recent ones. An event holds the
+/// address of the ScopeId, its type, a time stamp read from the time stamp
+/// counter when it is usable (see TscClock) and a 64 bits payload. Recording
+/// neither locks nor allocates, except for the ring allocated at the first
+/// event of a thread, and takes about 10 nanoseconds.
+///
+/// The rings are written on demand by writeFlightRecord, or automatically
+/// on a crash (see dumpFlightRecordOnCrash) or when a scope lasts too long
+/// (see dumpFlightRecordWhenLonger).
+///
+/// \code
+///   static const hpp::debug::ScopeId solveId("solve");
+///   hpp::debug::FlightScope scope(solveId, problemIndex);
+/// \endcode
+class FlightScope {
+ public:
+  /// \param payload value exported with the beginning event.
+  explicit FlightScope(const ScopeId& id, std::uint64_t payload = 0)
+      : id_(id),
+        start_(internal::flightRecord(id, internal::FlightBegin, payload)) {}
+
+  ~FlightScope() {
+    const std::uint64_t end =
+        internal::flightRecord(id_, internal::FlightEnd, 0);
+    if (internal::flightTriggersArmed.load(std::memory_order_relaxed))
+      internal::checkFlightTrigger(id_, end - start_);
+  }
+
+ private:
+  FlightScope(const FlightScope&) = delete;
+  FlightScope& operator=(const FlightScope&) = delete;
+
+  const ScopeId& id_;
+  const std::uint64_t start_;
+};
+
+/// \brief Record an instant event in the flight recorder.
+inline void flightRecord(const ScopeId& id, std::uint64_t payload = 0) {
+  internal::flightRecord(id, internal::FlightInstant, payload);
+}
+
+/// \brief Set the number of events kept by each thread.
+///
+/// The capacity is rounded up to a power of two and applies to the threads
+/// recording their first event afterwards. The default is 4096 events of
+/// 24 bytes.
+HPP_UTIL_DLLAPI void setFlightRecorderCapacity(std::size_t eventsPerThread);
+
+/// \brief Write the events kept by the flight recorder in the Chrome trace
+///        event format.
+///
+/// The output can be loaded in Perfetto or chrome://tracing. The payloads
+/// are written in the arguments of the events. Events can be written while
+/// other threads record new ones: the events overwritten during the export
+/// are skipped.
+HPP_UTIL_DLLAPI std::ostream& writeFlightRecord(std::ostream& os);
+
+/// \brief Write the events kept by the flight recorder to a file.
+/// \return false if the file could not be written.
+HPP_UTIL_DLLAPI bool writeFlightRecord(const std::string& filename);
+
+/// \brief Set the prefix of the files written automatically.
+///
+/// The n-th automatic export is written to <code>prefix.n.json</code>. The
+/// default prefix is <code>flight-record.PID</code> in the logging directory
+/// (see getFilename).
+HPP_UTIL_DLLAPI void setFlightRecordPrefix(const std::string& prefix);
+
+/// \brief Write the flight recorder when the process receives \c SIGSEGV,
+///        \c SIGBUS, \c SIGFPE, \c SIGILL or \c SIGABRT.
+///
+/// The previous handler of the signal is restored and called after the
+/// export. The export neither locks nor allocates.
+/// \return false if the platform is not supported.
+HPP_UTIL_DLLAPI bool dumpFlightRecordOnCrash();
+
+/// \brief Write the flight recorder once, the first time a FlightScope of
+///        the given identifier lasts more than \c seconds.
+///
+/// The export is done by the thread leaving the scope. At most 16 triggers
+/// can be armed.
+HPP_UTIL_DLLAPI void dumpFlightRecordWhenLonger(const ScopeId& id,
+                                                double seconds);
+
+/// \}
+}  // namespace debug
+}  // namespace hpp
+
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \brief Record the current scope in the flight recorder, see FlightScope.
+/// \param name an identifier, used as the name of the scope.
+#define hppTraceScope(name)                                           \
+  static const ::hpp::debug::ScopeId _##name##_flightscopeid_(#name); \
+  ::hpp::debug::FlightScope _##name##_flightscope_(_##name##_flightscopeid_)
+
+/// \brief Record an instant event with a payload in the flight recorder.
+/// \param name an identifier, used as the name of the event.
+#define hppTrace(name, payload)                                    \
+  do {                                                             \
+    static const ::hpp::debug::ScopeId _##name##_flightid_(#name); \
+    ::hpp::debug::flightRecord(_##name##_flightid_, (payload));    \
+  } while (0)
+
+/// \}
+
+#endif  // HPP_UTIL_FLIGHT_RECORDER_HH
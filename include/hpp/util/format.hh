@@ -0,0 +1,273 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_FORMAT_HH
+#define HPP_UTIL_FORMAT_HH
+
+#include <hpp/util/config.hh>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace hpp {
+namespace debug {
+/// \brief Minimal formatting library used by the logging macros.
+///
+/// The format string follows a subset of the \c std::format syntax:
+/// \li <code>{}</code> writes the next argument,
+/// \li <code>{:.N}</code> sets the precision (number of decimals for
+///     floating point numbers, maximal length for strings),
+/// \li a trailing type among \c f (fixed), \c e (scientific),
+///     \c g (general) and \c x (hexadecimal integer) may follow,
+///     as in <code>{:.3f}</code> or <code>{:x}</code>,
+/// \li <code>{{</code> and <code>}}</code> write a brace.
+///
+/// Integers and floating point numbers are written without iostreams.
+/// Other types are written with their \c operator<<.
+namespace format {
+/// \brief Replacement field specification.
+struct Spec {
+  /// Precision, -1 if not specified.
+  int precision;
+  /// Type, \c '\0' if not specified.
+  char type;
+};
+
+/// \cond
+namespace internal {
+constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+constexpr bool isType(char c) {
+  return c == 'f' || c == 'e' || c == 'g' || c == 'x';
+}
+}  // namespace internal
+/// \endcond
+
+/// \brief Number of replacement fields of \c fmt, or -1 if \c fmt is invalid.
+constexpr int countFields(const char* fmt) {
+  int n = 0;
+  for (int i = 0; fmt[i] != '\0'; ++i) {
+    if (fmt[i] == '{') {
+      if (fmt[i + 1] == '{') {
+        ++i;
+        continue;
+      }
+      ++i;
+      if (fmt[i] == ':') {
+        ++i;
+        if (fmt[i] == '.') {
+          ++i;
+          if (!internal::isDigit(fmt[i])) return -1;
+          while (internal::isDigit(fmt[i])) ++i;
+        }
+        if (internal::isType(fmt[i])) ++i;
+      }
+      if (fmt[i] != '}') return -1;
+      ++n;
+    } else if (fmt[i] == '}') {
+      if (fmt[i + 1] != '}') return -1;
+      ++i;
+    }
+  }
+  return n;
+}
+
+/// \brief Append the literal text of \c fmt until the next replacement field.
+/// \return a pointer after the replacement field, whose specification is
+///         stored in \c spec, or NULL if the end of \c fmt was reached.
+HPP_UTIL_DLLAPI const char* appendLiteral(std::string& out, const char* fmt,
+                                          Spec& spec);
+
+HPP_UTIL_DLLAPI void append(std::string& out, const Spec& spec, long long v);
+HPP_UTIL_DLLAPI void append(std::string& out, const Spec& spec,
+                            unsigned long long v);
+HPP_UTIL_DLLAPI void append(std::string& out, const Spec& spec, double v);
+HPP_UTIL_DLLAPI void append(std::string& out, const Spec& spec, bool v);
+HPP_UTIL_DLLAPI void append(std::string& out, const Spec& spec, char v);
+HPP_UTIL_DLLAPI void append(std::string& out, const Spec& spec,
+                            const char* v);
+HPP_UTIL_DLLAPI void append(std::string& out, const Spec& spec,
+                            const std::string& v);
+
+/// \cond
+namespace internal {
+enum Category { Bool, Char, Signed, Unsigned, Floating, String, Stream };
+
+template <typename T>
+struct category {
+  static constexpr Category value =
+      std::is_same<T, bool>::value   ? Bool
+      : std::is_same<T, char>::value ? Char
+      : std::is_integral<T>::value
+          ? (std::is_signed<T>::value ? Signed : Unsigned)
+      : std::is_floating_point<T>::value ? Floating
+      : (std::is_convertible<const T&, const char*>::value ||
+         std::is_same<T, std::string>::value)
+          ? String
+          : Stream;
+};
+
+template <typename T>
+inline void appendArg(std::string& out, const Spec& spec, const T& v,
+                      std::integral_constant<Category, Bool>) {
+  append(out, spec, static_cast<bool>(v));
+}
+
+template <typename T>
+inline void appendArg(std::string& out, const Spec& spec, const T& v,
+                      std::integral_constant<Category, Char>) {
+  append(out, spec, static_cast<char>(v));
+}
+
+template <typename T>
+inline void appendArg(std::string& out, const Spec& spec, const T& v,
+                      std::integral_constant<Category, Signed>) {
+  append(out, spec, static_cast<long long>(v));
+}
+
+template <typename T>
+inline void appendArg(std::string& out, const Spec& spec, const T& v,
+                      std::integral_constant<Category, Unsigned>) {
+  append(out, spec, static_cast<unsigned long long>(v));
+}
+
+template <typename T>
+inline void appendArg(std::string& out, const Spec& spec, const T& v,
+                      std::integral_constant<Category, Floating>) {
+  append(out, spec, static_cast<double>(v));
+}
+
+template <typename T>
+inline void appendArg(std::string& out, const Spec& spec, const T& v,
+                      std::integral_constant<Category, String>) {
+  append(out, spec, v);
+}
+
+template <typename T>
+inline void appendArg(std::string& out, const Spec&, const T& v,
+                      std::integral_constant<Category, Stream>) {
+  std::ostringstream ss;
+  ss << v;
+  out += ss.str();
+}
+
+inline void formatTo(std::string& out, const char* fmt) {
+  Spec spec;
+  while (fmt) fmt = appendLiteral(out, fmt, spec);
+}
+
+template <typename T, typename... Args>
+inline void formatTo(std::string& out, const char* fmt, const T& first,
+                     const Args&... args) {
+  Spec spec;
+  fmt = appendLiteral(out, fmt, spec);
+  if (!fmt) return;
+  appendArg(out, spec, first,
+            std::integral_constant<Category, category<T>::value>());
+  formatTo(out, fmt, args...);
+}
+}  // namespace internal
+/// \endcond
+
+/// \brief Append to \c out the formatted arguments.
+///
+/// \tparam Format a class with a static constexpr method \c str returning
+///         the format string, which is checked at compile time against
+///         the number of arguments. See the macro \ref HPP_FORMAT_TO.
+template <typename Format, typename... Args>
+inline void formatTo(std::string& out, const Args&... args) {
+  static_assert(countFields(Format::str()) >= 0, "Invalid format string.");
+  static_assert(countFields(Format::str()) == int(sizeof...(Args)),
+                "The number of arguments does not match the format string.");
+  internal::formatTo(out, Format::str(), args...);
+}
+
+/// \cond
+namespace internal {
+/// \brief formatTo, called by HPP_FORMAT_TO with the format string as first
+///        argument, which is the string returned by \c Format::str.
+template <typename Format, typename... Args>
+inline void formatLiteralTo(std::string& out, const char*,
+                            const Args&... args) {
+  format::formatTo<Format>(out, args...);
+}
+}  // namespace internal
+/// \endcond
+
+/// \brief Per-thread buffer in which log records are formatted.
+///
+/// The buffer of the thread is reused to avoid allocations. A nested use,
+/// for instance from the \c operator<< of an argument, falls back to a
+/// buffer local to the object.
+class HPP_UTIL_DLLAPI Buffer {
+ public:
+  Buffer();
+  ~Buffer();
+
+  std::string& str() { return *str_; }
+
+ private:
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+
+  std::string* str_;
+  std::string local_;
+};
+}  // namespace format
+}  // namespace debug
+}  // namespace hpp
+
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \cond
+// First argument of a non-empty list, without the GNU extension ##__VA_ARGS__.
+#define HPP_FORMAT_STRING(...) HPP_FORMAT_STRING_(__VA_ARGS__, unused)
+#define HPP_FORMAT_STRING_(fmt, ...) fmt
+/// \endcond
+
+/// \brief Append to the \c std::string \c out the formatting of the
+/// arguments according to the string literal that comes first.
+///
+/// The format string is checked at compile time.
+/// \code
+///   HPP_FORMAT_TO(str, "solved in {} iterations, cost {:.3f}", n, c);
+/// \endcode
+#define HPP_FORMAT_TO(out, ...)                                    \
+  do {                                                             \
+    struct __hpp_format {                                          \
+      static constexpr const char* str() {                         \
+        return HPP_FORMAT_STRING(__VA_ARGS__);                     \
+      }                                                            \
+    };                                                             \
+    ::hpp::debug::format::internal::formatLiteralTo<__hpp_format>( \
+        out, __VA_ARGS__);                                         \
+  } while (0)
+
+/// \}
+
+#endif  // HPP_UTIL_FORMAT_HH
@@ -0,0 +1,146 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#ifndef HPP_UTIL_HISTOGRAM_HH
+#define HPP_UTIL_HISTOGRAM_HH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <hpp/util/config.hh>
+#include <hpp/util/serialization-fwd.hh>
+#include <iosfwd>
+
+namespace hpp {
+namespace debug {
+/// \brief Fixed size log-linear histogram of durations.
+///
+/// Durations are counted in nanoseconds. Values below \f$ 2^p \f$, where
+/// \f$ p \f$ is the precision, have their own bucket. Above, each power of two
+/// is split in \f$ 2^{p-1} \f$ buckets, so that the relative error on the
+/// values is at most \f$ 2^{1-p} \f$. Values above \f$ 2^r \f$ ns, where
+/// \f$ r \f$ is the range, are counted in the last bucket.
+///
+/// The number of buckets is \f$ 2^p + (r-p) 2^{p-1} \f$. It is allocated at
+/// construction and recording a value is O(1) without allocation. With the
+/// default parameters, values up to 18 minutes are recorded with a 6% error
+/// in 592 buckets.
+///
+/// Like the shards of Sharded, a histogram is meant to be written by a single
+/// thread while others may read it.
+///
+/// Histograms are serializable, only the non empty buckets being saved.
+class HPP_UTIL_DLLAPI Histogram {
+ public:
+  typedef std::uint64_t count_type;
+
+  /// \param precision number of bits of the values kept, between 1 and 16.
+  /// \param range number of bits of the largest value, between
+  ///        precision + 1 and 64.
+  /// \throw std::invalid_argument if the parameters are out of bounds.
+  explicit Histogram(unsigned precision = 5, unsigned range = 40);
+  Histogram(const Histogram& other);
+  Histogram& operator=(const Histogram& other);
+  ~Histogram();
+
+  unsigned precision() const { return precision_; }
+  unsigned range() const { return range_; }
+
+  /// \brief Number of buckets.
+  std::size_t size() const { return size_; }
+
+  /// \brief Number of values recorded in a bucket.
+  count_type bucket(std::size_t index) const {
+    return counts_[index].load(std::memory_order_relaxed);
+  }
+
+  /// \brief Record a duration, in seconds.
+  void record(double seconds) {
+    std::atomic<count_type>& c = counts_[index(nanoseconds(seconds))];
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  /// \brief Add the counts of \c other.
+  /// \throw std::invalid_argument if the histograms have different precision
+  ///        or range.
+  void merge(const Histogram& other);
+
+  void reset();
+
+  /// \brief Number of recorded values.
+  count_type count() const;
+
+  /// \brief Value, in seconds, below which \c p percent of the values are.
+  ///
+  /// The upper bound of the bucket holding the value is returned, 0 if the
+  /// histogram is empty.
+  double percentile(double p) const;
+
+  /// \brief Write the 50th, 90th, 99th and 99.9th percentiles.
+  std::ostream& print(std::ostream& os) const;
+
+  /// \brief Index of the bucket of a value in nanoseconds.
+  std::size_t index(std::uint64_t ns) const {
+    const std::uint64_t half = std::uint64_t(1) << (precision_ - 1);
+    if (ns < 2 * half) return (std::size_t)ns;
+    const unsigned shift = mostSignificantBit(ns) + 1 - precision_;
+    const std::size_t i =
+        (std::size_t)((shift + 1) * half + (ns >> shift) - half);
+    return i < size_ ? i : size_ - 1;
+  }
+
+  /// \brief Largest value, in nanoseconds, of a bucket.
+  std::uint64_t upperBound(std::size_t index) const;
+
+ private:
+  static std::uint64_t nanoseconds(double seconds) {
+    if (!(seconds > 0)) return 0;
+    if (seconds >= 1.8e10) return UINT64_MAX;
+    return (std::uint64_t)(seconds * 1e9);
+  }
+
+  static unsigned mostSignificantBit(std::uint64_t v) {
+#ifdef __GNUC__
+    return 63u - (unsigned)__builtin_clzll(v);
+#else
+    unsigned r = 0;
+    while (v >>= 1) ++r;
+    return r;
+#endif
+  }
+
+  unsigned precision_, range_;
+  std::size_t size_;
+  std::atomic<count_type>* counts_;
+
+  HPP_SERIALIZABLE_SPLIT();
+};
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_HISTOGRAM_HH
@@ -0,0 +1,242 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#ifndef HPP_UTIL_MUTEX_HH
+#define HPP_UTIL_MUTEX_HH
+
+#include <atomic>
+#include <hpp/util/config.hh>
+#include <hpp/util/histogram.hh>
+#include <hpp/util/timer.hh>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace hpp {
+namespace debug {
+/// \brief Acquisitions of a mutex and the time spent waiting for it.
+///
+/// Like the time counters, it registers itself in the registry used by
+/// dumpTimeCounters. The count of the snapshot is the number of
+/// acquisitions, the times are the waits, an uncontended acquisition counting
+/// as a wait of zero.
+///
+/// The uncontended acquisitions only increment a counter. The waits of the
+/// contended acquisitions are measured and recorded in a Histogram.
+///
+/// A counter may be shared by several mutexes, such as the mutexes of the
+/// nodes of a roadmap, which then appear as one entry of the report.
+class HPP_UTIL_DLLAPI LockCounter : public TimeCounterBase {
+ public:
+  explicit LockCounter(const std::string& name);
+  ~LockCounter();
+
+  /// \brief Record an exclusive acquisition without waiting.
+  void acquired() { acquisitions_.fetch_add(1, std::memory_order_relaxed); }
+
+  /// \brief Record a shared acquisition without waiting.
+  void acquiredShared() { shared_.fetch_add(1, std::memory_order_relaxed); }
+
+  /// \brief Record an acquisition after waiting \c seconds.
+  void waited(double seconds, bool shared);
+
+  /// \brief Record a failed call to \c try_lock or \c try_lock_shared.
+  void failedTry() { failedTries_.fetch_add(1, std::memory_order_relaxed); }
+
+  /// \brief Number of acquisitions, shared or exclusive.
+  unsigned long acquisitions() const;
+  /// \brief Number of shared acquisitions.
+  unsigned long sharedAcquisitions() const;
+  /// \brief Number of acquisitions which had to wait.
+  unsigned long contended() const;
+  /// \brief Number of failed calls to \c try_lock or \c try_lock_shared.
+  unsigned long failedTries() const;
+  /// \brief Total time spent waiting, in seconds.
+  double waitTime() const;
+
+  /// \brief Wait time below which \c p percent of the acquisitions are.
+  double percentile(double p) const;
+
+  /// \brief Reset the statistics.
+  /// \note Acquisitions recorded concurrently may be lost.
+  void reset();
+
+  Snapshot snapshot() const;
+  bool isThreadSafe() const { return true; }
+
+  std::ostream& print(std::ostream& os) const;
+
+ private:
+  LockCounter(const LockCounter&) = delete;
+  LockCounter& operator=(const LockCounter&) = delete;
+
+  std::atomic<unsigned long> acquisitions_, shared_, failedTries_;
+
+  /// Statistics of the contended acquisitions, updated without lock so
+  /// that recording does not serialize the mutexes sharing the counter.
+  std::atomic<unsigned long> contended_;
+  std::atomic<double> waitTime_, minWait_, maxWait_;
+  Histogram waits_;
+};
+
+std::ostream& operator<<(std::ostream& os, const LockCounter& lc);
+
+/// \brief Counter shared by the mutexes constructed without a name.
+HPP_UTIL_DLLAPI LockCounter& defaultLockCounter();
+
+/// \brief Drop-in replacement of \c std::mutex recording its contention in a
+///        LockCounter.
+///
+/// \c lock first tries to acquire the mutex. Only when this fails, the wait
+/// is measured. An uncontended \c try_lock thus costs one relaxed atomic
+/// increment more than with a \c std::mutex, and an uncontended \c lock
+/// costs a \c try_lock, which is a few nanoseconds slower than \c lock with
+/// glibc.
+///
+/// A mutex constructed with a name owns its LockCounter, which registers a
+/// Histogram of a few kilobytes. Many mutexes, such as one per node of a
+/// roadmap, should rather share a counter:
+/// \code
+///   ProfiledMutex mutex("roadmap");
+///   std::lock_guard<ProfiledMutex> lock(mutex);
+///
+///   LockCounter nodeLocks("roadmap nodes");
+///   ProfiledMutex nodeMutex(nodeLocks);
+/// \endcode
+class HPP_UTIL_DLLAPI ProfiledMutex {
+ public:
+  /// \brief Mutex recording its contention in defaultLockCounter.
+  ProfiledMutex() : counter_(defaultLockCounter()) {}
+
+  /// \brief Mutex recording its contention in its own counter.
+  explicit ProfiledMutex(const std::string& name)
+      : own_(new LockCounter(name)), counter_(*own_) {}
+
+  /// \brief Mutex recording its contention in \c counter, which must
+  ///        outlive it.
+  explicit ProfiledMutex(LockCounter& counter) : counter_(counter) {}
+
+  void lock() {
+    if (mutex_.try_lock())
+      counter_.acquired();
+    else
+      lockContended();
+  }
+
+  bool try_lock() {
+    if (mutex_.try_lock()) {
+      counter_.acquired();
+      return true;
+    }
+    counter_.failedTry();
+    return false;
+  }
+
+  void unlock() { mutex_.unlock(); }
+
+  const LockCounter& counter() const { return counter_; }
+  LockCounter& counter() { return counter_; }
+
+ private:
+  ProfiledMutex(const ProfiledMutex&) = delete;
+  ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+  void lockContended();
+
+  std::mutex mutex_;
+  std::unique_ptr<LockCounter> own_;
+  LockCounter& counter_;
+};
+
+/// \brief Drop-in replacement of \c std::shared_timed_mutex recording its
+///        contention in a LockCounter.
+///
+/// The timed locking functions are not provided.
+/// \sa ProfiledMutex
+class HPP_UTIL_DLLAPI ProfiledSharedMutex {
+ public:
+  ProfiledSharedMutex() : counter_(defaultLockCounter()) {}
+  explicit ProfiledSharedMutex(const std::string& name)
+      : own_(new LockCounter(name)), counter_(*own_) {}
+  explicit ProfiledSharedMutex(LockCounter& counter) : counter_(counter) {}
+
+  void lock() {
+    if (mutex_.try_lock())
+      counter_.acquired();
+    else
+      lockContended();
+  }
+
+  bool try_lock() {
+    if (mutex_.try_lock()) {
+      counter_.acquired();
+      return true;
+    }
+    counter_.failedTry();
+    return false;
+  }
+
+  void unlock() { mutex_.unlock(); }
+
+  void lock_shared() {
+    if (mutex_.try_lock_shared())
+      counter_.acquiredShared();
+    else
+      lockSharedContended();
+  }
+
+  bool try_lock_shared() {
+    if (mutex_.try_lock_shared()) {
+      counter_.acquiredShared();
+      return true;
+    }
+    counter_.failedTry();
+    return false;
+  }
+
+  void unlock_shared() { mutex_.unlock_shared(); }
+
+  const LockCounter& counter() const { return counter_; }
+  LockCounter& counter() { return counter_; }
+
+ private:
+  ProfiledSharedMutex(const ProfiledSharedMutex&) = delete;
+  ProfiledSharedMutex& operator=(const ProfiledSharedMutex&) = delete;
+
+  void lockContended();
+  void lockSharedContended();
+
+  std::shared_timed_mutex mutex_;
+  std::unique_ptr<LockCounter> own_;
+  LockCounter& counter_;
+};
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_MUTEX_HH
@@ -0,0 +1,71 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_PERF_COUNTERS_HH
+#define HPP_UTIL_PERF_COUNTERS_HH
+
+#include <cstdint>
+#include <hpp/util/config.hh>
+
+namespace hpp {
+namespace debug {
+/// \brief Hardware performance counters of the calling thread.
+///
+/// On Linux, each thread opens, on its first read, a group of counters with
+/// \c perf_event_open, restricted to the user space. The counters of the
+/// group are read together with a single system call.
+///
+/// The events that cannot be opened, for instance because of the value of
+/// <code>/proc/sys/kernel/perf_event_paranoid</code>, or because the
+/// processor or the hypervisor does not expose them, are reported as
+/// unavailable. On other platforms, no event is available.
+class HPP_UTIL_DLLAPI PerfCounters {
+ public:
+  enum Event { Cycles, Instructions, CacheMisses, BranchMisses, NbEvents };
+
+  /// \brief Values of the counters.
+  struct Sample {
+    std::uint64_t values[NbEvents];
+    /// Bit \c e is set if event \c e is available.
+    unsigned mask;
+
+    bool has(Event e) const { return (mask & (1u << e)) != 0; }
+  };
+
+  /// \brief Read the counters of the calling thread.
+  /// \return false if no event is available.
+  static bool read(Sample& sample);
+
+  /// \brief Whether event \c e is available in the calling thread.
+  static bool isAvailable(Event e);
+
+  static const char* name(Event e);
+};
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_PERF_COUNTERS_HH
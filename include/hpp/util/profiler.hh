@@ -0,0 +1,185 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#ifndef HPP_UTIL_PROFILER_HH
+#define HPP_UTIL_PROFILER_HH
+
+#include <chrono>
+#include <cstddef>
+#include <hpp/util/clock.hh>
+#include <hpp/util/config.hh>
+#include <hpp/util/debug.hh>
+#include <hpp/util/trace.hh>
+#include <iosfwd>
+
+namespace hpp {
+namespace debug {
+/// \cond
+namespace internal {
+struct ProfileNode;
+}  // namespace internal
+/// \endcond
+
+/// \brief Static identifier of a profiled scope.
+///
+/// Identifiers are meant to be static objects, so that entering a scope does
+/// not involve any string manipulation. See HPP_PROFILE_SCOPE.
+class HPP_UTIL_DLLAPI ScopeId {
+ public:
+  /// \param name name of the scope in the reports. It is not copied.
+  explicit ScopeId(const char* name);
+
+  std::size_t index() const { return index_; }
+  const char* name() const { return name_; }
+
+  /// \brief Name of the scope of a given index.
+  static const char* name(std::size_t index);
+
+ private:
+  ScopeId(const ScopeId&) = delete;
+  ScopeId& operator=(const ScopeId&) = delete;
+
+  const char* name_;
+  std::size_t index_;
+};
+
+/// \brief Measure the time spent in a scope and record it in the call tree of
+/// the calling thread.
+///
+/// Nested ProfileScope objects build, for each thread, a tree whose nodes are
+/// the paths of scope identifiers. Each node accumulates the number of calls
+/// and the time spent in it, so that a scope called from different places
+/// appears in several nodes.
+///
+/// \sa printProfile, printCollapsedProfile
+class HPP_UTIL_DLLAPI ProfileScope {
+ public:
+  typedef DefaultClock clock_type;
+
+  /// \param enabled whether to measure the scope.
+  explicit ProfileScope(const ScopeId& id, bool enabled = true)
+      : trace_(enabled ? id.name() : NULL), node_(NULL) {
+    if (enabled) enter(id);
+  }
+
+  ~ProfileScope() {
+    if (node_) leave();
+  }
+
+ private:
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+  void enter(const ScopeId& id);
+  void leave();
+
+  TraceScope trace_;
+  internal::ProfileNode* node_;
+  clock_type::time_point start_;
+};
+
+/// \brief Write the call trees of all threads, merged, as an indented tree.
+///
+/// Each node shows the number of calls, the inclusive time (time spent in the
+/// scope) and the exclusive time (time spent in the scope minus the time
+/// spent in its profiled children), in seconds.
+HPP_UTIL_DLLAPI std::ostream& printProfile(std::ostream& os);
+
+/// \brief Write the call trees of all threads, merged, in the collapsed stack
+/// format used to build flame graphs.
+///
+/// Each line contains the path of a node, with names separated by \c ; and
+/// its exclusive time in nanoseconds.
+HPP_UTIL_DLLAPI std::ostream& printCollapsedProfile(std::ostream& os);
+
+/// \brief Reset the counts and times of the call trees of all threads.
+///
+/// The samples of the sampling profiler are reset too.
+/// \note Measurements recorded concurrently may be lost.
+HPP_UTIL_DLLAPI void resetProfile();
+
+/// \brief Start the sampling profiler.
+///
+/// At the given frequency of consumed CPU time, \c SIGPROF interrupts a
+/// running thread of the process (see \c setitimer and \c ITIMER_PROF). The
+/// signal handler attributes the sample to the node of the call tree of
+/// the thread that is active, i.e. to the stack of ProfileScope objects, and
+/// keeps the interrupted instruction pointer.
+///
+/// The cost is proportional to the frequency, not to the number of calls,
+/// and the signal handler neither allocates nor locks. The instruction
+/// pointers are stored in a buffer of \c capacity samples per thread, emptied
+/// by the reports. When the buffer is full, the sample is still counted but
+/// its instruction pointer is lost.
+///
+/// \return false if the timer could not be started or if the platform is not
+///         supported (only Linux is).
+/// \throw std::invalid_argument if frequency or capacity is not positive.
+/// \note The signal handler replaces any previous handler of \c SIGPROF, so
+///       this cannot be combined with other profilers relying on it.
+HPP_UTIL_DLLAPI bool startSampling(double frequency = 1000,
+                                   std::size_t capacity = 1 << 14);
+
+/// \brief Stop the sampling profiler. The samples are kept.
+HPP_UTIL_DLLAPI void stopSampling();
+
+/// \brief Write the samples of all threads, merged, as an indented tree.
+///
+/// Each node shows its number of samples, including the samples of its
+/// children, and the percentages of samples in the node with and without its
+/// children, followed by the \c maxIps most sampled instruction pointers
+/// in the node, with their symbol when available.
+HPP_UTIL_DLLAPI std::ostream& printSamplingProfile(std::ostream& os,
+                                                   std::size_t maxIps = 3);
+
+/// \brief Write printSamplingProfile to the benchmark journal when the
+///        program exits.
+HPP_UTIL_DLLAPI void dumpSamplingProfileAtExit();
+}  // namespace debug
+}  // namespace hpp
+
+#if defined(HPP_ENABLE_BENCHMARK) || defined(HPP_ENABLE_RUNTIME_BENCHMARK)
+
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \brief Record the time spent in the current scope in the call tree of the
+/// calling thread.
+/// \sa hpp::debug::ProfileScope
+#define HPP_PROFILE_SCOPE(name)                                        \
+  static const ::hpp::debug::ScopeId _##name##_profilescopeid_(#name); \
+  ::hpp::debug::ProfileScope _##name##_profilescope_(                  \
+      _##name##_profilescopeid_, HPP_BENCHMARK_IS_ENABLED())
+
+/// \}
+
+#else  // HPP_ENABLE_BENCHMARK || HPP_ENABLE_RUNTIME_BENCHMARK
+#define HPP_PROFILE_SCOPE(name)
+#endif  // HPP_ENABLE_BENCHMARK || HPP_ENABLE_RUNTIME_BENCHMARK
+
+#endif  // HPP_UTIL_PROFILER_HH
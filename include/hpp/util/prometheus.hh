@@ -0,0 +1,127 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#ifndef HPP_UTIL_PROMETHEUS_HH
+#define HPP_UTIL_PROMETHEUS_HH
+
+#include <condition_variable>
+#include <hpp/util/config.hh>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hpp {
+namespace debug {
+/// \brief Default upper bounds of the buckets written by
+///        writeTimeCountersPrometheus: the powers of ten from 1 microsecond
+///        to 10 seconds.
+HPP_UTIL_DLLAPI const std::vector<double>& defaultPrometheusBuckets();
+
+/// \brief Write the registered time counters in the Prometheus text
+///        exposition format.
+///
+/// Each counter is a series, labelled by its name, of the histogram
+/// \c hpp_time_counter_seconds. The counters with the same name are merged.
+/// The count and the sum are written for all the counters, the buckets
+/// only if all the counters of the name have a Histogram. A bucket counts
+/// the values of the Histogram buckets whose upper bound is below its
+/// bound, so it may miss values close to the bound, within the precision of
+/// the Histogram. The maximum is written in the gauge
+/// \c hpp_time_counter_max_seconds.
+///
+/// The event counters are written in the counter \c hpp_event_count_total
+/// and the gauges in the gauge \c hpp_gauge, also labelled by their names.
+///
+/// \param buckets upper bounds of the buckets, in seconds, in increasing
+///        order.
+/// \param threadSafeOnly see snapshotTimeCounters.
+HPP_UTIL_DLLAPI std::ostream& writeTimeCountersPrometheus(
+    std::ostream& os,
+    const std::vector<double>& buckets = defaultPrometheusBuckets(),
+    bool threadSafeOnly = false);
+
+/// \brief Write writeTimeCountersPrometheus to a file, atomically.
+///
+/// The metrics are written to <code>path + ".tmp"</code>, which is then
+/// renamed as \c path, so that readers never see a partial file.
+/// \return false if the file could not be written.
+HPP_UTIL_DLLAPI bool writeTimeCountersPrometheus(
+    const std::string& path,
+    const std::vector<double>& buckets = defaultPrometheusBuckets(),
+    bool threadSafeOnly = false);
+
+/// \brief Thread writing periodically the time counters to a file in the
+///        Prometheus text exposition format.
+///
+/// This is meant for the textfile collector of the Prometheus node exporter,
+/// in which case \c path should end with \c .prom. The counters are read
+/// like in dumpTimeCounters, without stopping the threads which record
+/// measurements. Hence the counters which are not thread safe, such as
+/// TimeCounter, are not exported, see TimeCounterBase::isThreadSafe.
+/// \code
+///   PrometheusExporter exporter("/var/lib/node_exporter/planner.prom", 15);
+/// \endcode
+class HPP_UTIL_DLLAPI PrometheusExporter {
+ public:
+  /// \brief Start the thread, which writes the file immediately and then
+  ///        every \c period seconds.
+  /// \throw std::invalid_argument if \c period is not positive.
+  PrometheusExporter(
+      const std::string& path, double period = 15,
+      const std::vector<double>& buckets = defaultPrometheusBuckets());
+
+  /// \brief Stop the thread and write the file a last time.
+  ~PrometheusExporter();
+
+  const std::string& path() const { return path_; }
+  double period() const { return period_; }
+
+ private:
+  PrometheusExporter(const PrometheusExporter&) = delete;
+  PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+  void run();
+  void write();
+
+  const std::string path_;
+  const double period_;
+  const std::vector<double> buckets_;
+  /// Whether the last write failed, so that failures are logged once.
+  bool failed_;
+
+  std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  bool stop_;
+  std::thread thread_;
+};
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_PROMETHEUS_HH
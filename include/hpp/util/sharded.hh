@@ -0,0 +1,163 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#ifndef HPP_UTIL_SHARDED_HH
+#define HPP_UTIL_SHARDED_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <hpp/util/config.hh>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace hpp {
+namespace debug {
+/// \brief Size used to pad data written by different threads.
+constexpr std::size_t cacheLineSize = 64;
+
+/// \cond
+namespace internal {
+/// \brief Type independent part of Sharded.
+class HPP_UTIL_DLLAPI ShardedBase {
+ protected:
+  ShardedBase();
+  ~ShardedBase();
+
+  /// \brief Shard of the calling thread, NULL if not created yet.
+  void* localShard() const {
+    const std::vector<Slot>& slots = threadShards_.slots;
+    if (id_ >= slots.size() || slots[id_].generation != generation_)
+      return NULL;
+    return slots[id_].shard;
+  }
+
+  /// \brief Take the shard released by a thread which exited, if any, as
+  ///        the shard of the calling thread.
+  /// \return the shard, NULL if none is free.
+  void* reuseShard();
+
+  /// \brief Register a new shard as the shard of the calling thread.
+  void addLocalShard(void* shard);
+
+  /// \brief Allocate memory aligned on a cache line.
+  static void* allocate(std::size_t size);
+  static void deallocate(void* ptr);
+
+  /// Index in the thread local arrays, reused once the object is
+  /// destroyed, so that the arrays are as long as the number of live
+  /// objects.
+  std::size_t id_;
+  /// Unique, to ignore the slots left by a destroyed object with the same
+  /// id.
+  std::uint64_t generation_;
+  mutable std::mutex mutex_;
+  std::vector<void*> shards_;
+
+ private:
+  ShardedBase(const ShardedBase&) = delete;
+  ShardedBase& operator=(const ShardedBase&) = delete;
+
+  struct Slot {
+    void* shard;
+    std::uint64_t generation;
+  };
+
+  /// Shards of a thread, released when it exits.
+  struct HPP_UTIL_DLLAPI ThreadShards {
+    ~ThreadShards();
+    /// Indexed by ShardedBase::id_.
+    std::vector<Slot> slots;
+  };
+
+  void setLocalShard(void* shard);
+
+  /// Shards released by the threads which exited.
+  std::vector<void*> freeShards_;
+
+  static thread_local ThreadShards threadShards_;
+};
+}  // namespace internal
+/// \endcond
+
+/// \brief One instance of \c T per thread.
+///
+/// The instance of a thread is created, aligned on a cache line, the first
+/// time the thread calls local(). Afterwards, local() costs a lookup in a
+/// thread local array. When a thread exits, its shard is kept, so that
+/// forEach() still visits its data, and handed over to the next thread
+/// calling local(), which continues from the values it holds. Hence the
+/// number of shards is the peak number of threads, not the number of
+/// threads ever created.
+///
+/// A shard is meant to be written by its thread only. Other threads may read
+/// it in forEach() while it is written, so its members should be atomics
+/// accessed with \c std::memory_order_relaxed.
+template <typename T>
+class Sharded : private internal::ShardedBase {
+ public:
+  Sharded() {}
+
+  ~Sharded() {
+    for (void* shard : shards_) {
+      static_cast<T*>(shard)->~T();
+      deallocate(shard);
+    }
+  }
+
+  /// \brief Shard of the calling thread.
+  T& local() {
+    void* shard = localShard();
+    if (shard == NULL) {
+      shard = reuseShard();
+      if (shard == NULL) {
+        shard = new (allocate(sizeof(T))) T();
+        addLocalShard(shard);
+      }
+    }
+    return *static_cast<T*>(shard);
+  }
+
+  /// \brief Apply \c f to each shard.
+  template <typename F>
+  void forEach(F f) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (void* shard : shards_) f(*static_cast<const T*>(shard));
+  }
+
+  /// \brief Apply \c f to each shard.
+  template <typename F>
+  void forEach(F f) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (void* shard : shards_) f(*static_cast<T*>(shard));
+  }
+};
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_SHARDED_HH
@@ -0,0 +1,190 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_UTIL_STATISTICS_HH
+#define HPP_UTIL_STATISTICS_HH
+
+#include <cstddef>
+#include <hpp/util/config.hh>
+#include <hpp/util/serialization-fwd.hh>
+#include <vector>
+
+namespace hpp {
+namespace debug {
+/// \brief Online mean and variance with Welford's algorithm.
+///
+/// The update is numerically stable, even when the variance is small
+/// compared to the mean.
+class HPP_UTIL_DLLAPI RunningStatistics {
+ public:
+  RunningStatistics() { reset(); }
+
+  void record(double x) {
+    ++n_;
+    double delta = x - mean_;
+    mean_ += delta / (double)n_;
+    m2_ += delta * (x - mean_);
+  }
+
+  /// \brief Combine with the statistics of another set of values.
+  void merge(const RunningStatistics& other);
+
+  void reset() {
+    n_ = 0;
+    mean_ = 0;
+    m2_ = 0;
+  }
+
+  unsigned long count() const { return n_; }
+  double mean() const { return mean_; }
+  /// \brief Unbiased variance, 0 if there are less than two values.
+  double variance() const { return (n_ > 1) ? m2_ / double(n_ - 1) : 0; }
+  double stddev() const;
+
+ private:
+  unsigned long n_;
+  double mean_, m2_;
+
+  HPP_SERIALIZABLE();
+};
+
+/// \brief Exponentially weighted moving average.
+///
+/// Each new value \f$ x \f$ updates the average as
+/// \f$ a \leftarrow a + \alpha (x - a) \f$. The first value initializes the
+/// average.
+class HPP_UTIL_DLLAPI ExponentialMovingAverage {
+ public:
+  /// \param alpha decay, in ]0, 1]. The larger, the more reactive.
+  /// \throw std::invalid_argument if alpha is out of bounds.
+  explicit ExponentialMovingAverage(double alpha = 0.1);
+
+  void record(double x) {
+    value_ = empty_ ? x : value_ + alpha_ * (x - value_);
+    empty_ = false;
+  }
+
+  void reset() {
+    value_ = 0;
+    empty_ = true;
+  }
+
+  double alpha() const { return alpha_; }
+  /// \brief Current average, 0 if no value was recorded.
+  double value() const { return value_; }
+
+ private:
+  double alpha_, value_;
+  bool empty_;
+};
+
+/// \brief Last values in a fixed size ring buffer.
+///
+/// The window holds the last \c capacity values. If a duration is given, the
+/// statistics only consider the values recorded in the last \c duration
+/// seconds, among the last \c capacity ones.
+class HPP_UTIL_DLLAPI RollingWindow {
+ public:
+  struct Summary {
+    std::size_t count;
+    double min, mean, stddev, max;
+  };
+
+  /// \param capacity maximal number of values, allocated here.
+  /// \param duration in seconds, 0 to consider all the values of the buffer.
+  /// \throw std::invalid_argument if capacity is 0 or duration is negative.
+  explicit RollingWindow(std::size_t capacity, double duration = 0);
+
+  /// \brief Record a value at time \c time, in seconds.
+  void record(double value, double time) {
+    Entry& e = entries_[next_];
+    e.value = value;
+    e.time = time;
+    if (++next_ == entries_.size()) next_ = 0;
+    if (size_ < entries_.size()) ++size_;
+  }
+
+  void reset() {
+    next_ = 0;
+    size_ = 0;
+  }
+
+  std::size_t capacity() const { return entries_.size(); }
+  double duration() const { return duration_; }
+
+  /// \brief Statistics of the values of the window.
+  /// \param now current time, in seconds, used if the duration is not 0.
+  /// All the fields are 0 if the window is empty.
+  Summary summary(double now) const;
+
+ private:
+  struct Entry {
+    double value, time;
+  };
+  std::vector<Entry> entries_;
+  std::size_t next_, size_;
+  double duration_;
+};
+
+/// \brief Median of \c values, 0 if empty.
+HPP_UTIL_DLLAPI double median(std::vector<double> values);
+
+/// \brief Median of the absolute deviations to the median, 0 if empty.
+///
+/// Unlike the standard deviation, it is not affected by a few outliers.
+/// Multiply by 1.4826 to estimate the standard deviation of a normal
+/// distribution.
+HPP_UTIL_DLLAPI double medianAbsoluteDeviation(
+    const std::vector<double>& values);
+
+/// \brief Result of a Mann-Whitney U test.
+struct MannWhitneyTest {
+  /// Number of pairs \f$ (a_i, b_j) \f$ with \f$ a_i > b_j \f$, ties
+  /// counting for one half.
+  double u;
+  /// Standard score of \c u.
+  double z;
+  /// Two-sided p-value of the hypothesis that both samples come from the
+  /// same distribution.
+  double pValue;
+};
+
+/// \brief Mann-Whitney U test of two samples.
+///
+/// The p-value uses the normal approximation, with the corrections for ties
+/// and continuity. It is accurate above about 8 values per sample.
+/// \throw std::invalid_argument if a sample is empty.
+HPP_UTIL_DLLAPI MannWhitneyTest mannWhitneyU(const std::vector<double>& a,
+                                             const std::vector<double>& b);
+
+/// \brief Quantile of the standard normal distribution.
+/// \param p probability, in ]0, 1[.
+HPP_UTIL_DLLAPI double normalQuantile(double p);
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_STATISTICS_HH
@@ -29,15 +29,31 @@
 #ifndef HPP_UTIL_TIMER_HH
 #define HPP_UTIL_TIMER_HH
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <functional>
+#include <hpp/util/allocation.hh>
+#include <hpp/util/clock.hh>
 #include <hpp/util/config.hh>
+#include <hpp/util/cpu-usage.hh>
 #include <hpp/util/debug.hh>
+#include <hpp/util/histogram.hh>
+#include <hpp/util/perf-counters.hh>
+#include <hpp/util/serialization-fwd.hh>
+#include <hpp/util/sharded.hh>
+#include <hpp/util/statistics.hh>
+#include <hpp/util/trace.hh>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace hpp {
 namespace debug {
 class HPP_UTIL_DLLAPI Timer {
  public:
-  typedef std::chrono::steady_clock clock_type;
+  typedef DefaultClock clock_type;
   typedef clock_type::time_point time_point;
   typedef std::chrono::duration<double> duration_type;
 
@@ -53,35 +69,57 @@ class HPP_UTIL_DLLAPI Timer {
   const time_point& getStart() const;
   const time_point& getStop() const;
 
+  /// \brief Read the CPU usage of the calling thread in start and stop.
+  ///
+  /// start and stop must then be called from the same thread. The CPU time
+  /// is added to print. See CpuUsage.
+  void enableCpuUsage(bool enable = true) { cpuEnabled_ = enable; }
+
+  /// \brief CPU usage between start and stop, zeros if not measured.
+  const CpuUsage& cpuUsage() const { return cpu_; }
+
   std::ostream& print(std::ostream&) const;
 
  private:
   time_point start_;
   time_point end_;
+  bool cpuEnabled_;
+  CpuUsage cpuStart_, cpu_;
 };
 
-#ifdef HPP_ENABLE_BENCHMARK
+#if defined(HPP_ENABLE_BENCHMARK) || defined(HPP_ENABLE_RUNTIME_BENCHMARK)
 
-#define hppStartBenchmark(ID)           \
-  hppDout(benchmark, #ID << ": start"); \
-  ::hpp::debug::Timer _##ID##_timer_(true)
+#define hppStartBenchmark(ID)                                 \
+  const bool _##ID##_benchmark_ = HPP_BENCHMARK_IS_ENABLED(); \
+  if (_##ID##_benchmark_) {                                   \
+    hppDout(benchmark, #ID << ": start");                     \
+    ::hpp::debug::traceBegin(#ID);                            \
+  }                                                           \
+  ::hpp::debug::Timer _##ID##_timer_(_##ID##_benchmark_)
 
-#define hppStopBenchmark(ID)             \
-  do {                                   \
-    _##ID##_timer_.stop();               \
-    hppDout(benchmark, #ID << ": stop"); \
+#define hppStopBenchmark(ID)               \
+  do {                                     \
+    if (_##ID##_benchmark_) {              \
+      _##ID##_timer_.stop();               \
+      ::hpp::debug::traceEnd(#ID);         \
+      hppDout(benchmark, #ID << ": stop"); \
+    }                                      \
   } while (0)
 
-#define hppDisplayBenchmark(ID) \
-  hppDout(benchmark, #ID << ": " << _##ID##_timer_.duration());
+#define hppDisplayBenchmark(ID)                                     \
+  do {                                                              \
+    if (_##ID##_benchmark_)                                         \
+      hppDout(benchmark, #ID << ": " << _##ID##_timer_.duration()); \
+  } while (0);
 
-#define hppBenchmark(data)                                                  \
-  do {                                                                      \
-    using namespace hpp;                                                    \
-    using namespace ::hpp::debug;                                           \
-    std::stringstream __ss;                                                 \
-    __ss << data << iendl;                                                  \
-    logging.benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
+#define hppBenchmark(data)                                                    \
+  do {                                                                        \
+    if (!HPP_BENCHMARK_IS_ENABLED()) break;                                   \
+    using namespace hpp;                                                      \
+    using namespace ::hpp::debug;                                             \
+    std::stringstream __ss;                                                   \
+    __ss << data << iendl;                                                    \
+    logging().benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
   } while (0)
 
 #else
@@ -89,46 +127,579 @@ class HPP_UTIL_DLLAPI Timer {
 #define hppStopBenchmark(ID)
 #define hppDisplayBenchmark(ID)
 #define hppBenchmark(data)
-#endif  // HPP_ENABLE_BENCHMARK
+#endif  // HPP_ENABLE_BENCHMARK || HPP_ENABLE_RUNTIME_BENCHMARK
+
+/// \brief Common interface of the time counters.
+///
+/// Each time counter registers itself, at construction, in a global registry
+/// used by snapshotTimeCounters, resetTimeCounters and dumpTimeCounters.
+///
+/// The counters which are not thread safe, see isThreadSafe, are only read
+/// by the functions called explicitly, and by the dump at exit. The dump on
+/// \c SIGUSR1 and PrometheusExporter, which read the registry from their own
+/// thread, skip them.
+class HPP_UTIL_DLLAPI TimeCounterBase {
+ public:
+  /// \brief Statistics of a time counter, in seconds.
+  struct Snapshot {
+    std::string name;
+    unsigned long count;
+    double totalTime, min, mean, max;
+    /// 99th percentile, NaN if the histogram is not enabled.
+    double p99;
+    /// CPU time of the thread over wall time, NaN if not measured.
+    double cpuRatio;
+  };
+
+  const std::string& name() const { return n_; }
+
+  /// \brief Name of the trace events, which outlives the counter.
+  const char* traceName() const { return traceName_; }
+
+  virtual Snapshot snapshot() const = 0;
+
+  /// \brief Whether snapshot and copyHistogram may be called while other
+  ///        threads record measurements.
+  virtual bool isThreadSafe() const { return false; }
+
+  /// \brief Copy of the histogram of the measurements, NULL if the counter
+  ///        has none.
+  virtual std::unique_ptr<Histogram> copyHistogram() const;
+
+  virtual void reset() = 0;
+  virtual std::ostream& print(std::ostream& os) const = 0;
+
+ protected:
+  TimeCounterBase(const std::string& name);
+  TimeCounterBase(const TimeCounterBase& other);
+  TimeCounterBase& operator=(const TimeCounterBase& other);
+  virtual ~TimeCounterBase();
+
+  /// \brief Add the counter to the registry.
+  ///
+  /// To be called at the end of the constructors of the derived classes,
+  /// once the object is fully built, since other threads may call its
+  /// virtual methods as soon as it is registered.
+  void publish();
+
+  /// \brief Remove the counter from the registry and keep its statistics
+  ///        for the dump at exit.
+  ///
+  /// To be called first in the destructor of the derived classes, before
+  /// their members are destroyed.
+  void unregister();
+
+  /// \brief Change the name of the counter.
+  void rename(const std::string& name);
+
+  std::string n_;
+
+ private:
+  const char* traceName_;
+};
+
+/// \brief Statistics of all the registered time counters.
+/// \param threadSafeOnly whether to skip the counters which are not thread
+///        safe, see TimeCounterBase::isThreadSafe.
+HPP_UTIL_DLLAPI std::vector<TimeCounterBase::Snapshot> snapshotTimeCounters(
+    bool threadSafeOnly = false);
+
+/// \brief Call \c f on each registered time counter.
+///
+/// The registry is locked during the calls, so \c f must neither create nor
+/// destroy a time counter.
+/// \param threadSafeOnly whether to skip the counters which are not thread
+///        safe, see TimeCounterBase::isThreadSafe.
+HPP_UTIL_DLLAPI void forEachTimeCounter(
+    const std::function<void(const TimeCounterBase&)>& f,
+    bool threadSafeOnly = false);
+
+/// \brief Reset all the registered time counters.
+HPP_UTIL_DLLAPI void resetTimeCounters();
+
+/// \brief Write a table of all the registered time counters, sorted by
+/// decreasing total time.
+///
+/// The table includes the counters retired since dumpTimeCountersAtExit was
+/// called.
+/// \param threadSafeOnly see snapshotTimeCounters.
+HPP_UTIL_DLLAPI std::ostream& dumpTimeCounters(std::ostream& os,
+                                               bool threadSafeOnly = false);
+
+/// \brief Write the table of dumpTimeCounters to the benchmark journal.
+HPP_UTIL_DLLAPI void dumpTimeCountersToJournal(bool threadSafeOnly = false);
+
+/// \brief Call dumpTimeCountersToJournal when the program exits.
+///
+/// The statistics of the counters destroyed before the exit handlers run
+/// are kept from the call onwards, so that they are part of the dump.
+///
+/// This is also enabled when the environment variable
+/// <code>HPP_DUMP_TIMECOUNTERS</code> contains \c exit, which is read when the
+/// first time counter is constructed.
+HPP_UTIL_DLLAPI void dumpTimeCountersAtExit();
+
+/// \brief Call dumpTimeCountersToJournal when the process receives
+/// \c SIGUSR1.
+///
+/// The signal handler only wakes up a thread dedicated to the dump, so that
+/// the dump does not run in the signal handler. As this thread runs
+/// concurrently with the measurements, the counters which are not thread
+/// safe, such as TimeCounter, are not part of the dump. Does nothing on
+/// platforms without \c SIGUSR1.
+///
+/// This is also enabled when the environment variable
+/// <code>HPP_DUMP_TIMECOUNTERS</code> contains \c sigusr1.
+HPP_UTIL_DLLAPI void dumpTimeCountersOnSignal();
+
+/// \brief Time recorded by the time counters for an empty section of code,
+///        in seconds.
+///
+/// This is the median duration between two consecutive reads of
+/// DefaultClock, through a function call. The statistics updates of the
+/// counters happen after the second read and are not part of it. It is
+/// measured by calibrateTimeCounterOverhead on the first call.
+HPP_UTIL_DLLAPI double timeCounterOverhead();
+
+/// \brief Measure the overhead with a calibration loop of \c iterations
+///        samples, and return it.
+///
+/// Subsequent calls to timeCounterOverhead return the new value. The counters
+/// which already subtract the overhead keep the previous value.
+HPP_UTIL_DLLAPI double calibrateTimeCounterOverhead(
+    std::size_t iterations = 100000);
 
 /// \brief Computation of min, max and mean time from a set of measurements.
-class HPP_UTIL_DLLAPI TimeCounter {
+///
+/// The statistics are not synchronized: they must not be read while another
+/// thread measures. Hence the counter is not thread safe, see
+/// TimeCounterBase::isThreadSafe, and only the dumps run by the thread
+/// measuring, or at exit, include it. Use ConcurrentTimeCounter to export
+/// the measurements while they are recorded.
+class HPP_UTIL_DLLAPI TimeCounter : public TimeCounterBase {
  public:
   struct Scope {
-    Scope(TimeCounter& t) : tc(t) { t.start(); }
-    ~Scope() { tc.stop(); }
+    /// \param enabled whether to measure the scope.
+    Scope(TimeCounter& t, bool enabled = true)
+        : tc(t), trace(enabled ? t.traceName() : NULL), enabled(enabled) {
+      if (enabled) t.start();
+    }
+    ~Scope() {
+      if (enabled) tc.stop();
+    }
 
     TimeCounter& tc;
+    TraceScope trace;
+    const bool enabled;
   };
 
-  typedef std::chrono::system_clock clock_type;
+  typedef DefaultClock clock_type;
   typedef clock_type::time_point time_point;
   typedef std::chrono::duration<double> duration_type;
 
   TimeCounter(const std::string& name);
+  TimeCounter(const TimeCounter& other);
+  TimeCounter& operator=(const TimeCounter& other);
+  ~TimeCounter();
 
   void start();
   double stop();
   double last();
   void reset();
 
+  /// \brief Add the measurements of \c other, for instance loaded from
+  ///        another process (see loadTimeCounters).
+  ///
+  /// The count, total, minimum, maximum, variance, histogram, performance
+  /// counters, allocations and CPU usage are combined. The moving average,
+  /// the rolling window and the last measurement are left unchanged.
+  ///
+  /// If only one of the counters has a histogram and both have
+  /// measurements, the histogram is dropped rather than describe a subset
+  /// of the measurements.
+  /// \throw std::invalid_argument if both counters have histograms of
+  ///        different precision or range.
+  void merge(const TimeCounter& other);
+
+  /// \brief Whether start was called and not followed by stop yet.
+  bool isRunning() const { return running_; }
+
+  unsigned long count() const { return c_; }
   double min() const;
   double max() const;
   double mean() const;
   double totalTime() const;
 
+  /// \brief Unbiased variance of the measurements.
+  double variance() const { return stats_.variance(); }
+  double stddev() const { return stats_.stddev(); }
+
+  /// \brief Subtract timeCounterOverhead from each measurement.
+  ///
+  /// The measurements are clamped to 0. All the statistics are computed from
+  /// the corrected measurements.
+  void subtractOverhead(bool enable = true);
+
+  /// \brief Overhead subtracted from each measurement, 0 if disabled.
+  double overhead() const { return overhead_.count(); }
+
+  /// \brief Set the decay of the exponentially weighted moving average.
+  ///
+  /// The moving average is reset. The default decay is 0.1.
+  /// \sa ExponentialMovingAverage
+  void setEwmaDecay(double alpha) { ewma_ = ExponentialMovingAverage(alpha); }
+
+  /// \brief Exponentially weighted moving average of the measurements.
+  double ewma() const { return ewma_.value(); }
+
+  /// \brief Keep the last measurements in a rolling window.
+  ///
+  /// The buffer is allocated here.
+  /// \param capacity number of measurements kept,
+  /// \param duration if not 0, restrict the statistics of the window to the
+  ///        measurements of the last \c duration seconds.
+  /// \sa RollingWindow
+  void enableWindow(std::size_t capacity, double duration = 0);
+
+  /// \brief Statistics of the measurements of the rolling window.
+  /// All the fields are 0 if the window is not enabled.
+  RollingWindow::Summary window() const;
+
+  /// \brief Record the measurements in a histogram.
+  ///
+  /// The histogram is allocated here. It should be enabled before the
+  /// measurements start. See Histogram for the meaning of the parameters.
+  void enableHistogram(unsigned precision = 5, unsigned range = 40);
+
+  /// \brief Histogram of the measurements, NULL if not enabled.
+  const Histogram* histogram() const { return h_.get(); }
+
+  std::unique_ptr<Histogram> copyHistogram() const;
+
+  /// \brief Value below which \c p percent of the measurements are.
+  /// \return NaN if the histogram is not enabled.
+  double percentile(double p) const;
+
+  /// \brief Read the hardware performance counters in start and stop.
+  ///
+  /// The counters of the thread calling start and stop are read, so that
+  /// start and stop must be called from the same thread. Each read is a
+  /// system call, which makes the measurements slower by about a
+  /// microsecond. The instructions per cycle and the misses per call are
+  /// added to print. See PerfCounters.
+  void enablePerfCounters(bool enable = true) { perfEnabled_ = enable; }
+
+  /// \brief Count the heap allocations between start and stop.
+  ///
+  /// Like enablePerfCounters, start and stop must be called from the same
+  /// thread. The allocations per call are added to print. This has no effect
+  /// if the allocation tracking is not available. See AllocationTracker.
+  void enableAllocationTracking(bool enable = true) { allocEnabled_ = enable; }
+
+  /// \brief Allocations counted between start and stop, in total.
+  const AllocationCounts& allocations() const { return alloc_; }
+
+  /// \brief Read the CPU usage of the calling thread in start and stop.
+  ///
+  /// Like enablePerfCounters, start and stop must be called from the same
+  /// thread. The CPU time over the wall time and the context switches per
+  /// call are added to print. When disabled, the CPU usage is not read at
+  /// all. See CpuUsage.
+  void enableCpuUsage(bool enable = true) { cpuEnabled_ = enable; }
+
+  /// \brief CPU usage between start and stop, in total.
+  const CpuUsage& cpuUsage() const { return cpu_; }
+
+  /// \brief CPU time of the thread over wall time, for the measurements in
+  ///        which the CPU usage was read.
+  /// \return NaN if the CPU usage was not read.
+  double cpuRatio() const;
+
+  /// \brief Mean increase of a hardware performance counter per call.
+  /// \return NaN if the counter was not measured.
+  double perfCounter(PerfCounters::Event e) const;
+
+  Snapshot snapshot() const;
+
   std::ostream& print(std::ostream& os) const;
 
  private:
-  std::string n_;
   unsigned long c_;
   duration_type t_, last_, min_, max_;
+  duration_type overhead_;
   time_point s_;
+  bool running_;
+  RunningStatistics stats_;
+  ExponentialMovingAverage ewma_;
+  std::unique_ptr<RollingWindow> w_;
+  std::unique_ptr<Histogram> h_;
+
+  bool perfEnabled_;
+  bool perfStarted_;
+  /// Number of calls for which the performance counters were read.
+  unsigned long perfCount_;
+  PerfCounters::Sample perfStart_, perf_;
+
+  bool allocEnabled_;
+  /// Tracker of the current measurement, NULL if not tracking.
+  const AllocationTracker* allocTracker_;
+  /// Number of calls for which the allocations were counted.
+  unsigned long allocCount_;
+  AllocationCounts allocStart_, alloc_;
+
+  bool cpuEnabled_;
+  bool cpuStarted_;
+  /// Number and wall time of the calls for which the CPU usage was read.
+  unsigned long cpuCount_;
+  duration_type cpuWall_;
+  CpuUsage cpuStart_, cpu_;
+
+  HPP_SERIALIZABLE_SPLIT();
 };
 
 std::ostream& operator<<(std::ostream& os, const TimeCounter& tc);
 
-#ifdef HPP_ENABLE_BENCHMARK
+/// \brief Save the statistics of all the registered TimeCounter objects in
+///        a binary archive.
+///
+/// Only the mergeable statistics are saved (see TimeCounter::merge), with
+/// the histograms reduced to their non empty buckets, so that the file is
+/// small enough to be written at the end of every job. The counters must
+/// not be measuring during the call. ConcurrentTimeCounter objects are not
+/// saved.
+/// \return false if the file could not be written.
+/// \sa the program \c hpp-util-merge-timecounters, which merges such files.
+HPP_UTIL_DLLAPI bool saveTimeCounters(const std::string& filename);
+
+/// \brief Load the time counters saved by saveTimeCounters.
+///
+/// The counters are registered like the others, so that dumpTimeCounters
+/// includes them.
+/// \throw std::runtime_error if the file cannot be read.
+HPP_UTIL_DLLAPI std::vector<std::unique_ptr<TimeCounter>> loadTimeCounters(
+    const std::string& filename);
+
+/// \brief TimeCounter that can be shared by several threads.
+///
+/// Each thread accumulates its measurements in its own shard, aligned on a
+/// cache line, so that recording a measurement does not involve any
+/// synchronization. The shards are merged when the statistics are queried.
+///
+/// Contrary to TimeCounter, the start time is kept by the caller, usually
+/// in a Scope.
+class HPP_UTIL_DLLAPI ConcurrentTimeCounter : public TimeCounterBase {
+ public:
+  typedef DefaultClock clock_type;
+  typedef clock_type::time_point time_point;
+  typedef std::chrono::duration<double> duration_type;
+
+  struct Scope {
+    /// \param enabled whether to measure the scope.
+    Scope(ConcurrentTimeCounter& t, bool enabled = true)
+        : tc(t),
+          trace(enabled ? t.traceName() : NULL),
+          enabled(enabled),
+          start(enabled ? clock_type::now() : time_point()) {}
+    ~Scope() {
+      if (enabled) tc.stop(start);
+    }
+
+    ConcurrentTimeCounter& tc;
+    TraceScope trace;
+    const bool enabled;
+    const time_point start;
+  };
+
+  ConcurrentTimeCounter(const std::string& name);
+  ~ConcurrentTimeCounter();
+
+  time_point start() const { return clock_type::now(); }
+
+  /// \brief Record the time elapsed since \c start.
+  double stop(const time_point& start) {
+    duration_type d = clock_type::now() - start - overhead_;
+    if (d.count() < 0) d = duration_type::zero();
+    record(d);
+    return d.count();
+  }
+
+  /// \brief Record one measurement in the shard of the calling thread.
+  inline void record(const duration_type& d);
+
+  /// \brief Last measurement of the calling thread.
+  double last();
+
+  /// \brief Reset the statistics.
+  /// \note Measurements recorded concurrently may be lost.
+  void reset();
+
+  unsigned long count() const;
+  double min() const;
+  double max() const;
+  double mean() const;
+  double totalTime() const;
+
+  /// \brief Record the measurements in histograms.
+  ///
+  /// Each thread allocates its histogram on its first measurement. This
+  /// should be called before the measurements start. See Histogram for the
+  /// meaning of the parameters.
+  void enableHistogram(unsigned precision = 5, unsigned range = 40);
+
+  /// \brief Subtract timeCounterOverhead from each measurement of stop.
+  ///
+  /// Like enableHistogram, it should be called before the measurements
+  /// start.
+  /// \sa TimeCounter::subtractOverhead
+  void subtractOverhead(bool enable = true);
+
+  /// \brief Overhead subtracted from each measurement, 0 if disabled.
+  double overhead() const { return overhead_.count(); }
+
+  /// \brief Merge of the histograms of all threads, NULL if not enabled.
+  std::unique_ptr<Histogram> histogram() const;
+
+  std::unique_ptr<Histogram> copyHistogram() const { return histogram(); }
+
+  /// \brief Value below which \c p percent of the measurements are.
+  /// \return NaN if the histograms are not enabled.
+  double percentile(double p) const;
+
+  Snapshot snapshot() const;
+  bool isThreadSafe() const { return true; }
+
+  std::ostream& print(std::ostream& os) const;
+
+ private:
+  struct alignas(cacheLineSize) Shard {
+    std::atomic<unsigned long> c;
+    std::atomic<double> t, last, min, max;
+    std::atomic<Histogram*> h;
+
+    Shard();
+    ~Shard();
+    void reset();
+  };
+
+  Histogram* createHistogram(Shard& shard);
+
+  struct Totals {
+    unsigned long c;
+    double t, min, max;
+  };
+
+  Totals merge() const;
+
+  unsigned histogramPrecision_, histogramRange_;
+  duration_type overhead_;
+  Sharded<Shard> shards_;
+};
+
+std::ostream& operator<<(std::ostream& os, const ConcurrentTimeCounter& tc);
+
+// Only the thread owning the shard writes it, hence the relaxed load and store
+// instead of read-modify-write operations.
+inline void ConcurrentTimeCounter::record(const duration_type& d) {
+  static constexpr std::memory_order relaxed = std::memory_order_relaxed;
+  Shard& s = shards_.local();
+  const double v = d.count();
+  s.last.store(v, relaxed);
+  if (v < s.min.load(relaxed)) s.min.store(v, relaxed);
+  if (v > s.max.load(relaxed)) s.max.store(v, relaxed);
+  s.t.store(s.t.load(relaxed) + v, relaxed);
+  s.c.store(s.c.load(relaxed) + 1, relaxed);
+  if (histogramPrecision_ != 0) {
+    Histogram* h = s.h.load(relaxed);
+    if (h == NULL) h = createHistogram(s);
+    h->record(v);
+  }
+}
+
+/// \brief Number of occurrences of an event, such as collision checks or
+///        cache hits.
+///
+/// Like ConcurrentTimeCounter, each thread counts in its own shard, aligned
+/// on a cache line, and the shards are summed when the value is queried.
+/// Incrementing costs the lookup of the shard of the thread and a non atomic
+/// addition.
+///
+/// Event counters are registered in the same registry as the time counters,
+/// so that dumpTimeCounters, resetTimeCounters and the Prometheus export
+/// include them.
+class HPP_UTIL_DLLAPI EventCounter {
+ public:
+  explicit EventCounter(const std::string& name);
+  ~EventCounter();
+
+  const std::string& name() const { return n_; }
+
+  /// \brief Add \c n to the count of the calling thread.
+  void increment(unsigned long n = 1) {
+    // Only the thread owning the shard writes it.
+    std::atomic<unsigned long>& v = shards_.local().value;
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  /// \brief Sum of the counts of all the threads.
+  unsigned long value() const;
+
+  /// \brief Reset the counts.
+  /// \note Increments done concurrently may be lost.
+  void reset();
+
+ private:
+  EventCounter(const EventCounter&) = delete;
+  EventCounter& operator=(const EventCounter&) = delete;
+
+  struct alignas(cacheLineSize) Shard {
+    Shard() : value(0) {}
+    std::atomic<unsigned long> value;
+  };
+
+  std::string n_;
+  Sharded<Shard> shards_;
+};
+
+/// \brief Current value of a quantity, such as the size of a roadmap.
+///
+/// Contrary to EventCounter, a gauge is not sharded: the value set by a
+/// thread replaces the values set by the others. It is registered like
+/// EventCounter.
+class HPP_UTIL_DLLAPI Gauge {
+ public:
+  explicit Gauge(const std::string& name);
+  ~Gauge();
+
+  const std::string& name() const { return n_; }
+
+  void set(double value) { value_.store(value, std::memory_order_relaxed); }
+
+  /// \brief Add \c delta to the value, atomically.
+  void add(double delta);
+
+  double value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  Gauge(const Gauge&) = delete;
+  Gauge& operator=(const Gauge&) = delete;
+
+  std::string n_;
+  std::atomic<double> value_;
+};
+
+/// \brief Value of an EventCounter or of a Gauge.
+struct MetricSnapshot {
+  std::string name;
+  /// Whether the metric is an EventCounter, otherwise it is a Gauge.
+  bool isCounter;
+  double value;
+};
+
+/// \brief Values of all the registered event counters, then of all the
+///        registered gauges.
+HPP_UTIL_DLLAPI std::vector<MetricSnapshot> snapshotMetrics();
+
+#if defined(HPP_ENABLE_BENCHMARK) || defined(HPP_ENABLE_RUNTIME_BENCHMARK)
 
 /// \addtogroup hpp_util_logging
 /// \{
@@ -136,40 +707,86 @@ std::ostream& operator<<(std::ostream& os, const TimeCounter& tc);
 /// \brief Define a new TimeCounter
 #define HPP_DEFINE_TIMECOUNTER(name) \
   ::hpp::debug::TimeCounter _##name##_timecounter_(#name)
+/// \brief Define a new ConcurrentTimeCounter, which can be used from several
+/// threads with HPP_SCOPE_TIMECOUNTER.
+#define HPP_DEFINE_CONCURRENT_TIMECOUNTER(name) \
+  ::hpp::debug::ConcurrentTimeCounter _##name##_timecounter_(#name)
 /// \brief Compute the time spent in the current scope.
-#define HPP_SCOPE_TIMECOUNTER(name)                             \
-  ::hpp::debug::TimeCounter::Scope _##name##_scopetimecounter_( \
-      _##name##_timecounter_)
+///
+/// \c _name_timecounter_ may also be a reference to a counter.
+#define HPP_SCOPE_TIMECOUNTER(name)                                      \
+  typename ::std::remove_reference<decltype(                             \
+      _##name##_timecounter_)>::type::Scope _##name##_scopetimecounter_( \
+      _##name##_timecounter_, HPP_BENCHMARK_IS_ENABLED())
+#ifdef HPP_ENABLE_BENCHMARK
 /// \brief Start a watch.
 #define HPP_START_TIMECOUNTER(name) _##name##_timecounter_.start()
 /// \brief Stop a watch and save elapsed time.
 #define HPP_STOP_TIMECOUNTER(name) _##name##_timecounter_.stop()
+#else
+// The watch is stopped if it was started, even if the benchmark was disabled
+// in the meantime.
+#define HPP_START_TIMECOUNTER(name) \
+  (HPP_BENCHMARK_IS_ENABLED() ? _##name##_timecounter_.start() : void())
+#define HPP_STOP_TIMECOUNTER(name)                                    \
+  (_##name##_timecounter_.isRunning() ? _##name##_timecounter_.stop() \
+                                      : 0.)
+#endif  // HPP_ENABLE_BENCHMARK
 /// \brief Print last elapsed time to the logs.
-#define HPP_DISPLAY_LAST_TIMECOUNTER(name)                                  \
-  do {                                                                      \
-    using namespace hpp;                                                    \
-    using namespace ::hpp::debug;                                           \
-    std::stringstream __ss;                                                 \
-    __ss << #name << " last: " << _##name##_timecounter_.last() << iendl;   \
-    logging.benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
+#define HPP_DISPLAY_LAST_TIMECOUNTER(name)                                    \
+  do {                                                                        \
+    if (!HPP_BENCHMARK_IS_ENABLED()) break;                                   \
+    using namespace hpp;                                                      \
+    using namespace ::hpp::debug;                                             \
+    std::stringstream __ss;                                                   \
+    __ss << #name << " last: " << _##name##_timecounter_.last() << iendl;     \
+    logging().benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
   } while (0)
 /// \brief Print min, max and mean time of the time measurements.
-#define HPP_DISPLAY_TIMECOUNTER(name)                                       \
-  do {                                                                      \
-    using namespace hpp;                                                    \
-    using namespace ::hpp::debug;                                           \
-    std::stringstream __ss;                                                 \
-    __ss << _##name##_timecounter_ << iendl;                                \
-    logging.benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
+#define HPP_DISPLAY_TIMECOUNTER(name)                                         \
+  do {                                                                        \
+    if (!HPP_BENCHMARK_IS_ENABLED()) break;                                   \
+    using namespace hpp;                                                      \
+    using namespace ::hpp::debug;                                             \
+    std::stringstream __ss;                                                   \
+    __ss << _##name##_timecounter_ << iendl;                                  \
+    logging().benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, __ss); \
   } while (0)
 /// \brief Reset a TimeCounter.
 #define HPP_RESET_TIMECOUNTER(name) _##name##_timecounter_.reset();
 /// \brief Stream (\c operator<<) to the output stream.
 #define HPP_STREAM_TIMECOUNTER(os, name) os << _##name##_timecounter_
+
+/// \brief Define a new EventCounter.
+#define HPP_DEFINE_COUNTER(name) \
+  ::hpp::debug::EventCounter _##name##_counter_(#name)
+/// \brief Define a new Gauge.
+#define HPP_DEFINE_GAUGE(name) ::hpp::debug::Gauge _##name##_gauge_(#name)
+#ifdef HPP_ENABLE_BENCHMARK
+/// \brief Add \c n to an EventCounter.
+#define HPP_ADD_COUNTER(name, n) _##name##_counter_.increment(n)
+/// \brief Set the value of a Gauge.
+#define HPP_SET_GAUGE(name, value) _##name##_gauge_.set(value)
+/// \brief Add \c delta to the value of a Gauge.
+#define HPP_ADD_GAUGE(name, delta) _##name##_gauge_.add(delta)
+#else
+#define HPP_ADD_COUNTER(name, n) \
+  (HPP_BENCHMARK_IS_ENABLED() ? _##name##_counter_.increment(n) : void())
+#define HPP_SET_GAUGE(name, value) \
+  (HPP_BENCHMARK_IS_ENABLED() ? _##name##_gauge_.set(value) : void())
+#define HPP_ADD_GAUGE(name, delta) \
+  (HPP_BENCHMARK_IS_ENABLED() ? _##name##_gauge_.add(delta) : void())
+#endif  // HPP_ENABLE_BENCHMARK
+/// \brief Increment an EventCounter.
+#define HPP_INCREMENT_COUNTER(name) HPP_ADD_COUNTER(name, 1)
+/// \brief Reset an EventCounter.
+#define HPP_RESET_COUNTER(name) _##name##_counter_.reset()
 /// \}
-#else  // HPP_ENABLE_BENCHMARK
+#else  // HPP_ENABLE_BENCHMARK || HPP_ENABLE_RUNTIME_BENCHMARK
 #define HPP_DEFINE_TIMECOUNTER(name) \
   struct _##name##_EndWithSemiColon_ {}
+#define HPP_DEFINE_CONCURRENT_TIMECOUNTER(name) \
+  struct _##name##_EndWithSemiColon_ {}
 #define HPP_SCOPE_TIMECOUNTER(name)
 #define HPP_START_TIMECOUNTER(name)
 #define HPP_STOP_TIMECOUNTER(name)
@@ -177,7 +794,16 @@ std::ostream& operator<<(std::ostream& os, const TimeCounter& tc);
 #define HPP_DISPLAY_TIMECOUNTER(name)
 #define HPP_RESET_TIMECOUNTER(name)
 #define HPP_STREAM_TIMECOUNTER(os, name) os
-#endif  // HPP_ENABLE_BENCHMARK
+#define HPP_DEFINE_COUNTER(name) \
+  struct _##name##_CounterEndWithSemiColon_ {}
+#define HPP_DEFINE_GAUGE(name) \
+  struct _##name##_GaugeEndWithSemiColon_ {}
+#define HPP_ADD_COUNTER(name, n)
+#define HPP_SET_GAUGE(name, value)
+#define HPP_ADD_GAUGE(name, delta)
+#define HPP_INCREMENT_COUNTER(name)
+#define HPP_RESET_COUNTER(name)
+#endif  // HPP_ENABLE_BENCHMARK || HPP_ENABLE_RUNTIME_BENCHMARK
 
 #define HPP_STOP_AND_DISPLAY_TIMECOUNTER(name) \
   HPP_STOP_TIMECOUNTER(name);                  \
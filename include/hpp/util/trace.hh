@@ -0,0 +1,129 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#ifndef HPP_UTIL_TRACE_HH
+#define HPP_UTIL_TRACE_HH
+
+#include <atomic>
+#include <cstddef>
+#include <hpp/util/config.hh>
+#include <iosfwd>
+#include <string>
+
+namespace hpp {
+namespace debug {
+/// \cond
+namespace internal {
+extern HPP_UTIL_DLLAPI std::atomic<bool> traceEnabled;
+
+HPP_UTIL_DLLAPI void traceEvent(const char* name, char phase);
+}  // namespace internal
+/// \endcond
+
+/// \addtogroup hpp_util_logging
+/// \{
+
+/// \brief Whether begin and end events of scopes are recorded.
+inline bool isTraceEnabled() {
+  return internal::traceEnabled.load(std::memory_order_relaxed);
+}
+
+/// \brief Start or stop recording begin and end events.
+///
+/// Events are recorded by hppStartBenchmark, hppStopBenchmark,
+/// TimeCounter::Scope, ConcurrentTimeCounter::Scope and ProfileScope.
+/// Each thread appends its events, with a time stamp read from the time stamp
+/// counter if it is usable, to its own buffer without locking. Use writeTrace
+/// to export them.
+HPP_UTIL_DLLAPI void enableTrace(bool enable);
+
+/// \brief Set the maximal number of events recorded by each thread.
+///
+/// Events are stored in chunks of 4096 events, so the capacity is rounded up
+/// to a multiple of 4096. Further events are dropped and their number is
+/// written in the trace. The default is \f$ 2^{20} \f$.
+HPP_UTIL_DLLAPI void setTraceCapacity(std::size_t eventsPerThread);
+
+/// \brief Copy of \c name that lives until the end of the program, for the
+///        names of the events.
+///
+/// The events only keep a pointer to their name, which writeTrace reads.
+/// Equal names share the same copy.
+HPP_UTIL_DLLAPI const char* internTraceName(const std::string& name);
+
+/// \brief Record the beginning of a scope if tracing is enabled.
+inline void traceBegin(const char* name) {
+  if (isTraceEnabled()) internal::traceEvent(name, 'B');
+}
+
+/// \brief Record the end of a scope if tracing is enabled.
+inline void traceEnd(const char* name) {
+  if (isTraceEnabled()) internal::traceEvent(name, 'E');
+}
+
+/// \brief Record the beginning and the end of a scope.
+///
+/// The end is recorded only if the beginning was, so that enabling tracing
+/// does not produce unmatched events. Nothing is recorded if \c name is NULL.
+/// \c name must remain valid until the events are written, see
+/// internTraceName.
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name) : name_(NULL) {
+    if (name != NULL && isTraceEnabled()) {
+      name_ = name;
+      internal::traceEvent(name_, 'B');
+    }
+  }
+
+  ~TraceScope() {
+    if (name_) internal::traceEvent(name_, 'E');
+  }
+
+ private:
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+  const char* name_;
+};
+
+/// \brief Write the recorded events in the Chrome trace event format.
+///
+/// The output can be loaded in Perfetto or chrome://tracing. Events can be
+/// written while other threads record new ones.
+HPP_UTIL_DLLAPI std::ostream& writeTrace(std::ostream& os);
+
+/// \brief Discard the recorded events.
+/// \warning No thread may record events during this call.
+HPP_UTIL_DLLAPI void clearTrace();
+
+/// \}
+}  // namespace debug
+}  // namespace hpp
+
+#endif  // HPP_UTIL_TRACE_HH
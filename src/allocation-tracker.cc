@@ -0,0 +1,146 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+// Replacement of the global operator new and operator delete counting the
+// allocations, built as the library hpp-util-alloc.
+// See hpp::debug::AllocationTracker.
+
+#include <cstdlib>
+#include <hpp/util/allocation.hh>
+#include <new>
+
+namespace {
+struct ThreadCounts {
+  // Number of nested tracking scopes.
+  unsigned depth;
+  hpp::debug::AllocationCounts counts;
+};
+
+// Constant initialized and initial exec, so that accessing it from
+// operator new neither allocates nor calls a TLS wrapper.
+thread_local ThreadCounts threadCounts
+    __attribute__((tls_model("initial-exec"))) = {0, {0, 0, 0}};
+
+void enter() { ++threadCounts.depth; }
+
+void leave() { --threadCounts.depth; }
+
+hpp::debug::AllocationCounts read() { return threadCounts.counts; }
+
+const hpp::debug::AllocationTracker tracker = {enter, leave, read};
+
+struct Registration {
+  Registration() { hpp::debug::setAllocationTracker(&tracker); }
+  ~Registration() { hpp::debug::setAllocationTracker(NULL); }
+} registration;
+
+inline void recordAllocation(std::size_t size) {
+  ThreadCounts& t = threadCounts;
+  if (t.depth == 0) return;
+  ++t.counts.allocations;
+  t.counts.bytes += size;
+}
+
+inline void recordFree(void* p) {
+  ThreadCounts& t = threadCounts;
+  if (t.depth == 0 || p == NULL) return;
+  ++t.counts.frees;
+}
+
+// Allocate like the default operator new, calling the new handler on
+// failure. Returns NULL if there is no new handler.
+void* allocate(std::size_t size) {
+  if (size == 0) size = 1;
+  for (;;) {
+    void* p = std::malloc(size);
+    if (p != NULL) return p;
+    std::new_handler handler = std::get_new_handler();
+    if (handler == NULL) return NULL;
+    handler();
+  }
+}
+}  // namespace
+
+void* operator new(std::size_t size) {
+  void* p = allocate(size);
+  if (p == NULL) throw std::bad_alloc();
+  recordAllocation(size);
+  return p;
+}
+
+void* operator new[](std::size_t size) {
+  void* p = allocate(size);
+  if (p == NULL) throw std::bad_alloc();
+  recordAllocation(size);
+  return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  void* p;
+  try {
+    p = allocate(size);
+  } catch (...) {
+    return NULL;
+  }
+  if (p != NULL) recordAllocation(size);
+  return p;
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept {
+  recordFree(p);
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  recordFree(p);
+  std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+  recordFree(p);
+  std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  recordFree(p);
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  recordFree(p);
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+  recordFree(p);
+  std::free(p);
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/allocation.hh"
+
+namespace hpp {
+namespace debug {
+namespace internal {
+std::atomic<const AllocationTracker*> allocationTracker(NULL);
+}  // namespace internal
+
+void setAllocationTracker(const AllocationTracker* tracker) {
+  internal::allocationTracker.store(tracker, std::memory_order_release);
+}
+
+AllocScope::AllocScope()
+    : tracker_(internal::allocationTracker.load(std::memory_order_acquire)),
+      start_{0, 0, 0} {
+  if (tracker_ == NULL) return;
+  tracker_->enter();
+  start_ = tracker_->read();
+}
+
+AllocScope::~AllocScope() {
+  if (tracker_ != NULL) tracker_->leave();
+}
+
+AllocationCounts AllocScope::counts() const {
+  if (tracker_ == NULL) return AllocationCounts{0, 0, 0};
+  return tracker_->read() - start_;
+}
+}  // namespace debug
+}  // namespace hpp
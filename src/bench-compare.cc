@@ -0,0 +1,159 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+// Compare two JSON files written by the benchmarks of hpp-util.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <hpp/util/benchmark.hh>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace hpp::debug;
+
+namespace {
+const char* usage =
+    "Usage: hpp-util-bench-compare [options] BASELINE.json CONTENDER.json\n"
+    "Options:\n"
+    "  --threshold=RATIO    minimal relative change of a regression\n"
+    "                       (default 0.05)\n"
+    "  --alpha=LEVEL        significance level of the test (default 0.05)\n"
+    "  --confidence=LEVEL   level of the confidence intervals (default 0.95)\n"
+    "Exits with status 1 if a benchmark regressed, 2 on errors.\n";
+
+const int regressionStatus = 1;
+const int errorStatus = 2;
+
+bool parseOption(const char* arg, const char* option, double& value) {
+  std::size_t n = std::strlen(option);
+  if (std::strncmp(arg, option, n) != 0 || arg[n] != '=') return false;
+  char* end;
+  value = std::strtod(arg + n + 1, &end);
+  if (arg[n + 1] == '\0' || *end != '\0' || !(value >= 0)) {
+    std::cerr << "Invalid value for " << option << '\n' << usage;
+    std::exit(errorStatus);
+  }
+  return true;
+}
+
+std::vector<BenchmarkResult> read(const char* filename) {
+  std::ifstream file(filename);
+  if (!file) {
+    std::cerr << "Failed to open " << filename << std::endl;
+    std::exit(errorStatus);
+  }
+  return readBenchmarksJson(file);
+}
+
+bool contains(const std::vector<BenchmarkResult>& results,
+              const std::string& name) {
+  for (const BenchmarkResult& r : results)
+    if (r.name == name) return true;
+  return false;
+}
+
+std::string percent(double ratio) {
+  std::ostringstream oss;
+  oss << std::showpos << std::fixed << std::setprecision(2) << 100 * ratio
+      << '%';
+  return oss.str();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  double threshold = 0.05, alpha = 0.05, confidence = 0.95;
+  std::vector<const char*> files;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--help") == 0) {
+      std::cout << usage;
+      return EXIT_SUCCESS;
+    }
+    if (parseOption(argv[i], "--threshold", threshold) ||
+        parseOption(argv[i], "--alpha", alpha) ||
+        parseOption(argv[i], "--confidence", confidence))
+      continue;
+    if (std::strncmp(argv[i], "--", 2) == 0) {
+      std::cerr << "Unknown option " << argv[i] << '\n' << usage;
+      return errorStatus;
+    }
+    files.push_back(argv[i]);
+  }
+  if (files.size() != 2) {
+    std::cerr << usage;
+    return errorStatus;
+  }
+
+  int status = EXIT_SUCCESS;
+  try {
+    std::vector<BenchmarkResult> baseline = read(files[0]),
+                                 contender = read(files[1]);
+    std::vector<BenchmarkComparison> comparisons =
+        compareBenchmarks(baseline, contender, confidence);
+
+    std::size_t width = 9;
+    for (const BenchmarkComparison& c : comparisons)
+      width = std::max(width, c.name.size());
+    std::cout << std::left << std::setw(int(width)) << "benchmark"
+              << std::right << std::setw(14) << "baseline" << std::setw(14)
+              << "contender" << std::setw(10) << "change" << std::setw(22)
+              << "confidence interval" << std::setw(10) << "p-value"
+              << "  verdict\n";
+    for (const BenchmarkComparison& c : comparisons) {
+      const char* verdict = "";
+      if (c.isRegression(alpha, threshold)) {
+        verdict = "REGRESSION";
+        status = regressionStatus;
+      } else if (c.isImprovement(alpha, threshold)) {
+        verdict = "improvement";
+      }
+      std::cout << std::left << std::setw(int(width)) << c.name << std::right
+                << std::setw(14) << c.baseline << std::setw(14)
+                << c.contender << std::setw(10) << percent(c.change)
+                << std::setw(22)
+                << ("[" + percent(c.changeLow) + ", " +
+                    percent(c.changeHigh) + "]")
+                << std::setw(10) << std::setprecision(3) << c.pValue
+                << std::setprecision(6) << "  " << verdict << '\n';
+    }
+    for (const BenchmarkResult& r : baseline)
+      if (!contains(contender, r.name))
+        std::cout << r.name << ": missing in " << files[1] << '\n';
+    for (const BenchmarkResult& r : contender)
+      if (!contains(baseline, r.name))
+        std::cout << r.name << ": missing in " << files[0] << '\n';
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return errorStatus;
+  }
+  return status;
+}
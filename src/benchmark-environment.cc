@@ -0,0 +1,178 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "hpp/util/benchmark-environment.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <hpp/util/exception-factory.hh>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace hpp {
+namespace debug {
+namespace {
+bool readLine(const std::string& path, std::string& line) {
+  std::ifstream file(path.c_str());
+  return bool(std::getline(file, line));
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+  std::ostringstream os;
+  for (std::size_t i = 0; i < cpus.size();) {
+    std::size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+    if (i > 0) os << ',';
+    os << cpus[i];
+    if (j > i) os << '-' << cpus[j];
+    i = j + 1;
+  }
+  return os.str();
+}
+}  // namespace
+
+std::vector<int> parseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  const char* s = list.c_str();
+  while (*s != '\0' && *s != '\n') {
+    char* end;
+    long first = std::strtol(s, &end, 10), last = first;
+    if (end == s || first < 0) break;
+    s = end;
+    if (*s == '-') {
+      last = std::strtol(s + 1, &end, 10);
+      if (end == s + 1 || last < first) break;
+      s = end;
+    }
+    for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(int(cpu));
+    if (*s == ',')
+      ++s;
+    else if (*s != '\0' && *s != '\n')
+      break;
+  }
+  if (*s != '\0' && *s != '\n')
+    HPP_THROW(std::invalid_argument, "Invalid list of processors " << list);
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+BenchmarkEnvironment::BenchmarkEnvironment() : turbo(-1) {
+  load[0] = load[1] = load[2] = -1;
+}
+
+BenchmarkEnvironment BenchmarkEnvironment::read(const std::string& root) {
+  const std::string cpu = root + "/sys/devices/system/cpu/";
+  BenchmarkEnvironment env;
+  std::string line;
+  // A malformed file is reported as unknown rather than thrown, since the
+  // environment only qualifies the measurements.
+  try {
+    if (readLine(cpu + "online", line)) env.cpus = parseCpuList(line);
+    if (readLine(cpu + "isolated", line)) env.isolated = parseCpuList(line);
+  } catch (const std::invalid_argument&) {
+  }
+  for (int i : env.cpus) {
+    std::ostringstream path;
+    path << cpu << "cpu" << i << "/cpufreq/scaling_governor";
+    if (!readLine(path.str(), line)) line.clear();
+    env.governors.push_back(line);
+  }
+
+  if (readLine(cpu + "intel_pstate/no_turbo", line) && !line.empty())
+    env.turbo = line[0] == '0';
+  else if (readLine(cpu + "cpufreq/boost", line) && !line.empty())
+    env.turbo = line[0] != '0';
+
+  std::ifstream loadavg((root + "/proc/loadavg").c_str());
+  double load[3];
+  if (loadavg >> load[0] >> load[1] >> load[2])
+    std::copy(load, load + 3, env.load);
+  return env;
+}
+
+std::vector<std::string> BenchmarkEnvironment::problems(double maxLoadPerCpu,
+                                                        int cpu) const {
+  std::vector<std::string> problems;
+  std::map<std::string, std::vector<int> > byGovernor;
+  for (std::size_t i = 0; i < governors.size(); ++i)
+    if (!governors[i].empty() && governors[i] != "performance")
+      byGovernor[governors[i]].push_back(cpus[i]);
+  for (const auto& g : byGovernor)
+    problems.push_back("processors " + formatCpuList(g.second) + " use the " +
+                       g.first + " frequency governor");
+  if (turbo == 1) problems.push_back("turbo boost is enabled");
+  // The number of processors is taken as 1 if unknown.
+  const double n = cpus.empty() ? 1. : double(cpus.size());
+  if (load[0] > maxLoadPerCpu * n) {
+    std::ostringstream os;
+    os << "load average " << load[0] << " is above " << maxLoadPerCpu
+       << " per processor on " << n << " processors";
+    problems.push_back(os.str());
+  }
+  if (cpu >= 0 && !isolated.empty() &&
+      !std::binary_search(isolated.begin(), isolated.end(), cpu)) {
+    std::ostringstream os;
+    os << "processor " << cpu << " is not isolated, isolated processors are "
+       << formatCpuList(isolated);
+    problems.push_back(os.str());
+  }
+  return problems;
+}
+
+std::ostream& operator<<(std::ostream& os, const BenchmarkEnvironment& env) {
+  os << "processors: "
+     << (env.cpus.empty() ? "unknown" : formatCpuList(env.cpus)) << '\n';
+
+  std::map<std::string, std::vector<int> > byGovernor;
+  for (std::size_t i = 0; i < env.governors.size(); ++i)
+    if (!env.governors[i].empty())
+      byGovernor[env.governors[i]].push_back(env.cpus[i]);
+  os << "frequency governors:";
+  if (byGovernor.empty()) os << " unknown";
+  for (const auto& g : byGovernor)
+    os << ' ' << g.first << " (" << formatCpuList(g.second) << ')';
+  os << '\n';
+
+  os << "turbo boost: "
+     << (env.turbo < 0 ? "unknown" : env.turbo ? "enabled" : "disabled")
+     << '\n';
+  os << "load average:";
+  if (env.load[0] < 0)
+    os << " unknown";
+  else
+    for (double l : env.load) os << ' ' << l;
+  os << '\n';
+  os << "isolated processors: "
+     << (env.isolated.empty() ? "none" : formatCpuList(env.isolated)) << '\n';
+  return os;
+}
+}  // namespace debug
+}  // namespace hpp
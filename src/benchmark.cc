@@ -0,0 +1,647 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/benchmark.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/util/statistics.hh>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <sched.h>
+#endif  // __linux__
+
+namespace hpp {
+namespace debug {
+BenchmarkState::BenchmarkState(std::size_t iterations)
+    : iterations_(iterations), remaining_(0), started_(false), paused_(0) {}
+
+bool BenchmarkState::startOrStop() {
+  if (!started_ && iterations_ > 0) {
+    started_ = true;
+    remaining_ = iterations_ - 1;
+    timer_.start();
+    return true;
+  }
+  timer_.stop();
+  return false;
+}
+
+void BenchmarkState::pauseTiming() { pause_.start(); }
+
+void BenchmarkState::resumeTiming() {
+  pause_.stop();
+  paused_ += pause_.duration();
+}
+
+double BenchmarkState::elapsed() const {
+  return std::max(timer_.duration() - paused_, 0.);
+}
+
+BenchmarkOptions::BenchmarkOptions()
+    : minTime(0.01),
+      repetitions(20),
+      warmupTime(0.1),
+      cpu(-1),
+      noise(WarnOnNoise),
+      maxLoadPerCpu(0.5) {}
+
+namespace {
+struct Registration {
+  std::string name;
+  BenchmarkFunction function;
+};
+
+// Leaked, as benchmarks register during the static initialization.
+std::vector<Registration>& registrations() {
+  static std::vector<Registration>* instance = new std::vector<Registration>;
+  return *instance;
+}
+
+double runSample(BenchmarkFunction f, std::size_t iterations) {
+  BenchmarkState state(iterations);
+  f(state);
+  return state.elapsed();
+}
+
+const std::size_t maxIterations = std::size_t(1) << 40;
+
+std::size_t chooseIterations(BenchmarkFunction f, double minTime) {
+  std::size_t n = 1;
+  while (n < maxIterations) {
+    double t = runSample(f, n);
+    if (t >= minTime) break;
+    // Aim 40% above the minimal time, growing by at most 100 times.
+    double factor = (t > 0) ? 1.4 * minTime / t : 100;
+    factor = std::min(std::max(factor, 2.), 100.);
+    n = std::min(std::size_t(double(n) * factor), maxIterations);
+  }
+  return n;
+}
+
+void checkEnvironment(const BenchmarkOptions& options) {
+  std::vector<std::string> problems =
+      BenchmarkEnvironment::read().problems(options.maxLoadPerCpu, options.cpu);
+  if (problems.empty()) return;
+  std::string message = "Noisy benchmark environment:";
+  for (const std::string& p : problems) message += "\n  " + p;
+  if (options.noise == BenchmarkOptions::RefuseNoise)
+    HPP_THROW(std::runtime_error, message);
+  // Not the warning channel, which is disabled at the default verbosity.
+  std::cerr << message << std::endl;
+}
+
+void writeJsonString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\')
+      os << '\\' << c;
+    else if ((unsigned char)c < 0x20)
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c)
+         << std::dec << std::setfill(' ');
+    else
+      os << c;
+  }
+  os << '"';
+}
+
+/// Write a CSV field, quoted if it contains a separator, a quote or a line
+/// break, as in RFC 4180.
+void writeCsvField(std::ostream& os, const std::string& str) {
+  if (str.find_first_of(",\"\r\n") == std::string::npos) {
+    os << str;
+    return;
+  }
+  os << '"';
+  for (char c : str) {
+    if (c == '"') os << '"';
+    os << c;
+  }
+  os << '"';
+}
+}  // namespace
+
+bool registerBenchmark(const char* name, BenchmarkFunction f) {
+  registrations().push_back(Registration{name, f});
+  return true;
+}
+
+BenchmarkResult runBenchmark(const std::string& name, BenchmarkFunction f,
+                             const BenchmarkOptions& options) {
+  if (options.repetitions == 0)
+    HPP_THROW(std::invalid_argument, "The number of repetitions must be > 0");
+  BenchmarkResult result;
+  result.name = name;
+  result.iterations = chooseIterations(f, options.minTime);
+
+  Timer warmup(true);
+  do {
+    runSample(f, result.iterations);
+    warmup.stop();
+  } while (warmup.duration() < options.warmupTime);
+
+  result.samples.reserve(options.repetitions);
+  for (std::size_t i = 0; i < options.repetitions; ++i)
+    result.samples.push_back(runSample(f, result.iterations) /
+                             double(result.iterations));
+
+  RunningStatistics stats;
+  for (double s : result.samples) stats.record(s);
+  result.median = median(result.samples);
+  result.mad = medianAbsoluteDeviation(result.samples);
+  result.mean = stats.mean();
+  result.min = *std::min_element(result.samples.begin(), result.samples.end());
+  result.max = *std::max_element(result.samples.begin(), result.samples.end());
+  return result;
+}
+
+std::vector<BenchmarkResult> runBenchmarks(const BenchmarkOptions& options) {
+  if (options.noise != BenchmarkOptions::IgnoreNoise)
+    checkEnvironment(options);
+  if (options.cpu >= 0 && !pinThreadToCpu(options.cpu))
+    HPP_THROW(std::runtime_error, "Failed to pin the thread to processor "
+                                      << options.cpu);
+  std::vector<BenchmarkResult> results;
+  for (const Registration& r : registrations())
+    if (r.name.find(options.filter) != std::string::npos)
+      results.push_back(runBenchmark(r.name, r.function, options));
+  return results;
+}
+
+bool pinThreadToCpu(int cpu) {
+#ifdef __linux__
+  if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif  // __linux__
+}
+
+std::ostream& printBenchmarks(std::ostream& os,
+                              const std::vector<BenchmarkResult>& results) {
+  std::size_t width = 9;
+  for (const BenchmarkResult& r : results)
+    width = std::max(width, r.name.size());
+  std::ios_base::fmtflags flags = os.flags();
+  os << std::left << std::setw(int(width)) << "benchmark" << std::right
+     << std::setw(14) << "iterations" << std::setw(14) << "median"
+     << std::setw(14) << "mad" << std::setw(14) << "min" << std::setw(14)
+     << "max" << '\n';
+  for (const BenchmarkResult& r : results)
+    os << std::left << std::setw(int(width)) << r.name << std::right
+       << std::setw(14) << r.iterations << std::setw(14) << r.median
+       << std::setw(14) << r.mad << std::setw(14) << r.min << std::setw(14)
+       << r.max << '\n';
+  os.flags(flags);
+  return os;
+}
+
+std::ostream& writeBenchmarksJson(std::ostream& os,
+                                  const std::vector<BenchmarkResult>& results) {
+  std::streamsize precision =
+      os.precision(std::numeric_limits<double>::max_digits10);
+  std::time_t now = std::time(NULL);
+  os << "{\n  \"context\": {\n    \"date\": \""
+     << std::put_time(std::localtime(&now), "%FT%T%z") << "\",\n"
+     << "    \"clock\": \""
+     << (std::is_same<DefaultClock, TscClock>::value && TscClock::isTscUsed()
+             ? "tsc"
+             : "steady_clock")
+     << "\"\n  },\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const BenchmarkResult& r = results[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\n      \"name\": ";
+    writeJsonString(os, r.name);
+    os << ",\n      \"iterations\": " << r.iterations
+       << ",\n      \"median\": " << r.median << ",\n      \"mad\": " << r.mad
+       << ",\n      \"mean\": " << r.mean << ",\n      \"min\": " << r.min
+       << ",\n      \"max\": " << r.max << ",\n      \"samples\": [";
+    for (std::size_t j = 0; j < r.samples.size(); ++j)
+      os << (j == 0 ? "" : ", ") << r.samples[j];
+    os << "]\n    }";
+  }
+  os << "\n  ]\n}\n";
+  os.precision(precision);
+  return os;
+}
+
+std::ostream& writeBenchmarksCsv(std::ostream& os,
+                                 const std::vector<BenchmarkResult>& results) {
+  std::streamsize precision =
+      os.precision(std::numeric_limits<double>::max_digits10);
+  os << "name,iterations,median,mad,mean,min,max\n";
+  for (const BenchmarkResult& r : results) {
+    writeCsvField(os, r.name);
+    os << ',' << r.iterations << ',' << r.median << ',' << r.mad << ','
+       << r.mean << ',' << r.min << ',' << r.max << '\n';
+  }
+  os.precision(precision);
+  return os;
+}
+
+namespace {
+/// Minimal JSON reader, enough to read the output of writeBenchmarksJson.
+struct JsonValue {
+  enum Type { Null, Boolean, Number, String, Array, Object } type;
+  double number;
+  std::string string;
+  std::vector<JsonValue> array;
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  JsonValue() : type(Null), number(0) {}
+
+  const JsonValue* find(const std::string& key) const {
+    for (const std::pair<std::string, JsonValue>& member : object)
+      if (member.first == key) return &member.second;
+    return NULL;
+  }
+};
+
+class JsonReader {
+ public:
+  JsonReader(std::istream& is) : is_(is) {}
+
+  JsonValue readDocument() {
+    JsonValue value = readValue();
+    skipSpaces();
+    if (is_.peek() != std::char_traits<char>::eof())
+      fail("unexpected character after the document");
+    return value;
+  }
+
+ private:
+  void fail(const char* message) {
+    HPP_THROW(std::runtime_error, "Invalid JSON: " << message);
+  }
+
+  void skipSpaces() {
+    while (std::isspace(is_.peek())) is_.get();
+  }
+
+  void expect(char c) {
+    skipSpaces();
+    if (is_.get() != c) fail("unexpected character");
+  }
+
+  void expectWord(const char* word) {
+    for (const char* c = word; *c != '\0'; ++c)
+      if (is_.get() != *c) fail("invalid literal");
+  }
+
+  std::string readString() {
+    expect('"');
+    std::string str;
+    for (int c = is_.get(); c != '"'; c = is_.get()) {
+      if (c == std::char_traits<char>::eof()) fail("unterminated string");
+      if (c == '\\') {
+        c = is_.get();
+        switch (c) {
+          case 'n':
+            c = '\n';
+            break;
+          case 't':
+            c = '\t';
+            break;
+          case 'r':
+            c = '\r';
+            break;
+          case 'b':
+            c = '\b';
+            break;
+          case 'f':
+            c = '\f';
+            break;
+          case 'u': {
+            char hex[5] = {0};
+            is_.read(hex, 4);
+            // Only ASCII characters are written by writeBenchmarksJson.
+            c = (int)std::strtol(hex, NULL, 16);
+            break;
+          }
+          default:
+            break;
+        }
+      }
+      str += char(c);
+    }
+    return str;
+  }
+
+  JsonValue readValue() {
+    skipSpaces();
+    JsonValue value;
+    int c = is_.peek();
+    if (c == '{') {
+      is_.get();
+      value.type = JsonValue::Object;
+      skipSpaces();
+      if (is_.peek() == '}') {
+        is_.get();
+        return value;
+      }
+      for (;;) {
+        std::string key = readString();
+        expect(':');
+        value.object.push_back(std::make_pair(key, readValue()));
+        skipSpaces();
+        if (is_.peek() != ',') break;
+        is_.get();
+      }
+      expect('}');
+    } else if (c == '[') {
+      is_.get();
+      value.type = JsonValue::Array;
+      skipSpaces();
+      if (is_.peek() == ']') {
+        is_.get();
+        return value;
+      }
+      for (;;) {
+        value.array.push_back(readValue());
+        skipSpaces();
+        if (is_.peek() != ',') break;
+        is_.get();
+      }
+      expect(']');
+    } else if (c == '"') {
+      value.type = JsonValue::String;
+      value.string = readString();
+    } else if (c == 't' || c == 'f') {
+      value.type = JsonValue::Boolean;
+      value.number = (c == 't');
+      expectWord(c == 't' ? "true" : "false");
+    } else if (c == 'n') {
+      expectWord("null");
+    } else {
+      value.type = JsonValue::Number;
+      if (!(is_ >> value.number)) fail("invalid number");
+    }
+    return value;
+  }
+
+  std::istream& is_;
+};
+
+double readNumber(const JsonValue& object, const char* key) {
+  const JsonValue* value = object.find(key);
+  if (value == NULL || value->type != JsonValue::Number)
+    HPP_THROW(std::runtime_error,
+              "Invalid benchmark results: missing number " << key);
+  return value->number;
+}
+}  // namespace
+
+std::vector<BenchmarkResult> readBenchmarksJson(std::istream& is) {
+  JsonValue document = JsonReader(is).readDocument();
+  const JsonValue* benchmarks = document.find("benchmarks");
+  if (benchmarks == NULL || benchmarks->type != JsonValue::Array)
+    HPP_THROW(std::runtime_error,
+              "Invalid benchmark results: missing benchmarks array");
+  std::vector<BenchmarkResult> results;
+  for (const JsonValue& b : benchmarks->array) {
+    const JsonValue* name = b.find("name");
+    const JsonValue* samples = b.find("samples");
+    if (name == NULL || name->type != JsonValue::String || samples == NULL ||
+        samples->type != JsonValue::Array)
+      HPP_THROW(std::runtime_error,
+                "Invalid benchmark results: missing name or samples");
+    BenchmarkResult r;
+    r.name = name->string;
+    r.iterations = (std::size_t)readNumber(b, "iterations");
+    for (const JsonValue& sample : samples->array) {
+      if (sample.type != JsonValue::Number)
+        HPP_THROW(std::runtime_error,
+                  "Invalid benchmark results: invalid sample of " << r.name);
+      r.samples.push_back(sample.number);
+    }
+    r.median = readNumber(b, "median");
+    r.mad = readNumber(b, "mad");
+    r.mean = readNumber(b, "mean");
+    r.min = readNumber(b, "min");
+    r.max = readNumber(b, "max");
+    results.push_back(r);
+  }
+  return results;
+}
+
+std::vector<BenchmarkComparison> compareBenchmarks(
+    const std::vector<BenchmarkResult>& baseline,
+    const std::vector<BenchmarkResult>& contender, double confidence) {
+  if (!(confidence > 0 && confidence < 1))
+    HPP_THROW(std::invalid_argument, "Invalid confidence level " << confidence);
+  const double z = normalQuantile(0.5 + confidence / 2);
+  std::vector<BenchmarkComparison> comparisons;
+  for (const BenchmarkResult& b : baseline) {
+    std::vector<BenchmarkResult>::const_iterator c = std::find_if(
+        contender.begin(), contender.end(),
+        [&b](const BenchmarkResult& r) { return r.name == b.name; });
+    if (c == contender.end() || b.samples.empty() || c->samples.empty())
+      continue;
+
+    BenchmarkComparison comparison;
+    comparison.name = b.name;
+    comparison.baseline = b.median;
+    comparison.contender = c->median;
+    comparison.pValue = mannWhitneyU(b.samples, c->samples).pValue;
+
+    // Hodges-Lehmann estimate of the ratio and its distribution-free
+    // confidence interval, derived from the distribution of the U statistic.
+    std::vector<double> ratios;
+    ratios.reserve(b.samples.size() * c->samples.size());
+    for (double x : b.samples)
+      if (x > 0)
+        for (double y : c->samples) ratios.push_back(y / x);
+    if (ratios.empty()) {
+      comparison.change = comparison.changeLow = comparison.changeHigh =
+          std::numeric_limits<double>::quiet_NaN();
+    } else {
+      std::sort(ratios.begin(), ratios.end());
+      // Only the positive baseline samples contribute ratios.
+      const double m = (double)c->samples.size(),
+                   n = (double)ratios.size() / m;
+      const double k =
+          std::floor(n * m / 2 - z * std::sqrt(n * m * (n + m + 1) / 12));
+      std::size_t low = (std::size_t)std::max(k, 0.);
+      std::size_t high = ratios.size() - 1 - std::min(low, ratios.size() - 1);
+      low = std::min(low, high);
+      comparison.change = median(ratios) - 1;
+      comparison.changeLow = ratios[low] - 1;
+      comparison.changeHigh = ratios[high] - 1;
+    }
+    comparisons.push_back(comparison);
+  }
+  return comparisons;
+}
+
+namespace {
+const char* usage =
+    "Options:\n"
+    "  --filter=STRING      run the benchmarks whose name contains STRING\n"
+    "  --min-time=SECONDS   minimal duration of a sample (default 0.01)\n"
+    "  --repetitions=N      number of samples (default 20)\n"
+    "  --warmup=SECONDS     duration of the warmup (default 0.1)\n"
+    "  --cpu=N              pin the thread to processor N\n"
+    "  --cpu=isolated       pin the thread to the first isolated processor\n"
+    "  --noise=POLICY       ignore, warn (default) or refuse when the\n"
+    "                       environment is noisy\n"
+    "  --max-load=LOAD      load average per processor above which the\n"
+    "                       environment is noisy (default 0.5)\n"
+    "  --json=FILE          write the results as JSON, - for stdout\n"
+    "  --csv=FILE           write the results as CSV, - for stdout\n"
+    "  --list               list the benchmarks and exit\n"
+    "  --help               print this message and exit\n";
+
+bool matchOption(const char* arg, const char* option, const char** value) {
+  std::size_t n = std::strlen(option);
+  if (std::strncmp(arg, option, n) != 0 || arg[n] != '=') return false;
+  *value = arg + n + 1;
+  return true;
+}
+
+double parseDouble(const char* option, const char* value) {
+  char* end;
+  double d = std::strtod(value, &end);
+  if (*value == '\0' || *end != '\0' || !(d >= 0))
+    HPP_THROW(std::invalid_argument,
+              "Invalid value " << value << " for option " << option);
+  return d;
+}
+
+long parseInteger(const char* option, const char* value) {
+  char* end;
+  long l = std::strtol(value, &end, 10);
+  if (*value == '\0' || *end != '\0' || l < 0)
+    HPP_THROW(std::invalid_argument,
+              "Invalid value " << value << " for option " << option);
+  return l;
+}
+
+BenchmarkOptions::NoisePolicy parseNoisePolicy(const char* value) {
+  if (std::strcmp(value, "ignore") == 0) return BenchmarkOptions::IgnoreNoise;
+  if (std::strcmp(value, "warn") == 0) return BenchmarkOptions::WarnOnNoise;
+  if (std::strcmp(value, "refuse") == 0) return BenchmarkOptions::RefuseNoise;
+  HPP_THROW(std::invalid_argument,
+            "Invalid value " << value << " for option --noise");
+}
+
+bool writeResults(const std::string& file,
+                  const std::vector<BenchmarkResult>& results,
+                  std::ostream& (*write)(std::ostream&,
+                                         const std::vector<BenchmarkResult>&)) {
+  if (file.empty()) return true;
+  if (file == "-") {
+    write(std::cout, results);
+    return true;
+  }
+  std::ofstream out(file.c_str());
+  if (!out) {
+    std::cerr << "Failed to open " << file << std::endl;
+    return false;
+  }
+  write(out, results);
+  return true;
+}
+}  // namespace
+
+int benchmarkMain(int argc, char** argv) {
+  BenchmarkOptions options;
+  std::string json, csv;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const char* arg = argv[i];
+      const char* value;
+      if (std::strcmp(arg, "--help") == 0) {
+        std::cout << "Usage: " << argv[0] << " [options]\n" << usage;
+        return EXIT_SUCCESS;
+      } else if (std::strcmp(arg, "--list") == 0) {
+        for (const Registration& r : registrations())
+          std::cout << r.name << '\n';
+        return EXIT_SUCCESS;
+      } else if (matchOption(arg, "--filter", &value)) {
+        options.filter = value;
+      } else if (matchOption(arg, "--min-time", &value)) {
+        options.minTime = parseDouble("--min-time", value);
+      } else if (matchOption(arg, "--repetitions", &value)) {
+        options.repetitions =
+            (std::size_t)parseInteger("--repetitions", value);
+      } else if (matchOption(arg, "--warmup", &value)) {
+        options.warmupTime = parseDouble("--warmup", value);
+      } else if (matchOption(arg, "--cpu", &value)) {
+        if (std::strcmp(value, "isolated") == 0) {
+          std::vector<int> isolated = BenchmarkEnvironment::read().isolated;
+          if (isolated.empty())
+            HPP_THROW(std::runtime_error, "No isolated processor");
+          options.cpu = isolated.front();
+        } else {
+          options.cpu = (int)parseInteger("--cpu", value);
+        }
+      } else if (matchOption(arg, "--noise", &value)) {
+        options.noise = parseNoisePolicy(value);
+      } else if (matchOption(arg, "--max-load", &value)) {
+        options.maxLoadPerCpu = parseDouble("--max-load", value);
+      } else if (matchOption(arg, "--json", &value)) {
+        json = value;
+      } else if (matchOption(arg, "--csv", &value)) {
+        csv = value;
+      } else {
+        HPP_THROW(std::invalid_argument, "Unknown option " << arg);
+      }
+    }
+
+    std::vector<BenchmarkResult> results = runBenchmarks(options);
+    // Keep stdout parsable when it receives the JSON or CSV output.
+    if (json != "-" && csv != "-") printBenchmarks(std::cout, results);
+    if (!writeResults(json, results, writeBenchmarksJson) ||
+        !writeResults(csv, results, writeBenchmarksCsv))
+      return EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\nUsage: " << argv[0] << " [options]\n"
+              << usage;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+}  // namespace debug
+}  // namespace hpp
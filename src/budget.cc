@@ -0,0 +1,255 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "hpp/util/budget.hh"
+
+#include <algorithm>
+#include <hpp/util/debug.hh>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/util/format.hh>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+namespace hpp {
+namespace debug {
+namespace {
+typedef Timer::clock_type clock_type;
+
+void checkBudget(const std::string& name, double budget) {
+  if (!(budget > 0))
+    HPP_THROW(std::invalid_argument,
+              "The budget of " << name << " must be positive, got " << budget);
+}
+
+// Bounds of the period between two reads of the clock by
+// BudgetScope::expired.
+constexpr std::chrono::nanoseconds minPeriod(1000);
+constexpr unsigned long maxStride = 1ul << 20;
+}  // namespace
+
+BudgetCounter::BudgetCounter(const std::string& name, double budget)
+    : TimeCounterBase(name),
+      budget_(budget),
+      logEnabled_(false),
+      logInterval_(1),
+      unlogged_(0) {
+  checkBudget(name, budget);
+  reset();
+  publish();
+}
+
+BudgetCounter::~BudgetCounter() { unregister(); }
+
+double BudgetCounter::budget() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return budget_;
+}
+
+void BudgetCounter::setBudget(double budget) {
+  checkBudget(n_, budget);
+  std::lock_guard<std::mutex> lock(mutex_);
+  budget_ = budget;
+}
+
+void BudgetCounter::onOverrun(const Callback& callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  callback_ = callback;
+}
+
+void BudgetCounter::enableOverrunLog(bool enable, double interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  logEnabled_ = enable;
+  logInterval_ = interval;
+  lastLog_ = Timer::time_point();
+  unlogged_ = 0;
+}
+
+void BudgetCounter::record(double duration) {
+  Callback callback;
+  double budget;
+  unsigned long unlogged = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++count_;
+    total_ += duration;
+    min_ = std::min(min_, duration);
+    max_ = std::max(max_, duration);
+    durations_.record(duration);
+    if (duration <= budget_) return;
+    budget = budget_;
+    const double overrun = duration - budget_;
+    ++overruns_;
+    totalOverrun_ += overrun;
+    maxOverrun_ = std::max(maxOverrun_, overrun);
+    callback = callback_;
+    if (logEnabled_) {
+      ++unlogged_;
+      const Timer::time_point now = clock_type::now();
+      if (lastLog_ == Timer::time_point() ||
+          Timer::duration_type(now - lastLog_).count() >= logInterval_) {
+        unlogged = unlogged_;
+        unlogged_ = 0;
+        lastLog_ = now;
+      }
+    }
+  }
+  // Outside of the lock, so that the callback may query the counter.
+  if (unlogged > 0)
+    hppLogf(warning,
+            "{} took {} s, exceeding its budget of {} s ({} overruns since "
+            "the last warning)",
+            n_, duration, budget, unlogged);
+  if (callback) callback(*this, duration);
+}
+
+unsigned long BudgetCounter::count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return count_;
+}
+
+double BudgetCounter::totalTime() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_;
+}
+
+unsigned long BudgetCounter::overruns() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return overruns_;
+}
+
+double BudgetCounter::totalOverrun() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return totalOverrun_;
+}
+
+double BudgetCounter::maxOverrun() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return maxOverrun_;
+}
+
+double BudgetCounter::percentile(double p) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return durations_.percentile(p);
+}
+
+void BudgetCounter::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  count_ = 0;
+  overruns_ = 0;
+  total_ = 0;
+  min_ = std::numeric_limits<double>::max();
+  max_ = 0;
+  totalOverrun_ = 0;
+  maxOverrun_ = 0;
+  durations_.reset();
+  unlogged_ = 0;
+}
+
+BudgetCounter::Snapshot BudgetCounter::snapshot() const {
+  Snapshot s;
+  s.name = n_;
+  s.cpuRatio = std::numeric_limits<double>::quiet_NaN();
+  std::lock_guard<std::mutex> lock(mutex_);
+  s.count = count_;
+  s.totalTime = total_;
+  s.min = (count_ > 0) ? min_ : 0;
+  s.mean = (count_ > 0) ? total_ / double(count_) : 0;
+  s.max = max_;
+  s.p99 = durations_.percentile(99);
+  return s;
+}
+
+std::unique_ptr<Histogram> BudgetCounter::copyHistogram() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::unique_ptr<Histogram>(new Histogram(durations_));
+}
+
+std::ostream& BudgetCounter::print(std::ostream& os) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  os << "Budget Counter " << n_ << ": " << count_ << ", " << total_ << ", [ "
+     << ((count_ > 0) ? min_ : 0) << ", "
+     << ((count_ > 0) ? total_ / double(count_) : 0) << ", " << max_
+     << "], budget " << budget_ << ", " << overruns_ << " overruns";
+  if (overruns_ == 0) return durations_.print(os << ", ");
+  os << " (" << 100. * double(overruns_) / double(count_) << "%), overrun [ "
+     << totalOverrun_ / double(overruns_) << ", " << maxOverrun_ << "], ";
+  return durations_.print(os);
+}
+
+std::ostream& operator<<(std::ostream& os, const BudgetCounter& bc) {
+  return bc.print(os);
+}
+
+BudgetScope::BudgetScope(BudgetCounter& counter)
+    : counter_(counter),
+      trace_(counter.traceName()),
+      timer_(true),
+      countdown_(1),
+      stride_(1),
+      expired_(false) {
+  const double budget = counter.budget();
+  lastRead_ = timer_.getStart();
+  deadline_ = lastRead_ + std::chrono::duration_cast<clock_type::duration>(
+                              Timer::duration_type(budget));
+  period_ = std::max<clock_type::duration>(
+      minPeriod, std::chrono::duration_cast<clock_type::duration>(
+                     Timer::duration_type(budget * 1e-3)));
+}
+
+BudgetScope::~BudgetScope() {
+  timer_.stop();
+  counter_.record(timer_.duration());
+}
+
+double BudgetScope::elapsed() const {
+  return Timer::duration_type(clock_type::now() - timer_.getStart()).count();
+}
+
+double BudgetScope::remaining() const {
+  return Timer::duration_type(deadline_ - clock_type::now()).count();
+}
+
+bool BudgetScope::readClock() {
+  if (expired_) return true;
+  const Timer::time_point now = clock_type::now();
+  if (now >= deadline_) {
+    expired_ = true;
+    return true;
+  }
+  // Adapt the number of calls between two reads to the period.
+  const clock_type::duration sinceLastRead = now - lastRead_;
+  if (sinceLastRead < period_ / 2 && stride_ < maxStride)
+    stride_ *= 2;
+  else if (sinceLastRead > 2 * period_ && stride_ > 1)
+    stride_ /= 2;
+  lastRead_ = now;
+  countdown_ = stride_;
+  return false;
+}
+}  // namespace debug
+}  // namespace hpp
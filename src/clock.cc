@@ -0,0 +1,147 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/clock.hh"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef HPP_UTIL_HAS_TSC
+#include <cpuid.h>
+#endif
+
+namespace hpp {
+namespace debug {
+namespace internal {
+namespace {
+#ifdef HPP_UTIL_HAS_TSC
+bool hasInvariantTsc() {
+  unsigned eax, ebx, ecx, edx;
+  if (__get_cpuid_max(0x80000000, NULL) < 0x80000007) return false;
+  __cpuid(0x80000007, eax, ebx, ecx, edx);
+  return (edx & (1u << 8)) != 0;
+}
+#endif
+
+TscCalibration calibrate() {
+  typedef std::chrono::steady_clock steady;
+  TscCalibration c;
+  c.usable = false;
+  c.tscOrigin = 0;
+  c.nsOrigin = 0;
+  c.nsPerTick = 0;
+#ifdef HPP_UTIL_HAS_TSC
+  const char* env = std::getenv("HPP_TSC_CLOCK");
+  if (env != NULL && std::strcmp(env, "0") == 0) return c;
+  if (!hasInvariantTsc()) return c;
+
+  // Measure the number of ticks during 10 milliseconds. Each end is taken
+  // as the read of the time stamp counter surrounded by the closest pair of
+  // reads of steady_clock, to reduce the error due to preemption.
+  struct Sample {
+    std::int64_t ns;
+    std::uint64_t ticks;
+  };
+  auto sample = []() {
+    Sample best = {0, 0};
+    std::int64_t bestWidth = -1;
+    for (int i = 0; i < 16; ++i) {
+      steady::time_point t0 = steady::now();
+      unsigned aux;
+      std::uint64_t ticks = __rdtscp(&aux);
+      steady::time_point t1 = steady::now();
+      std::int64_t width =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0)
+              .count();
+      if (bestWidth < 0 || width < bestWidth) {
+        bestWidth = width;
+        best.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      (t0 + (t1 - t0) / 2).time_since_epoch())
+                      .count();
+        best.ticks = ticks;
+      }
+    }
+    return best;
+  };
+  Sample begin = sample();
+  steady::time_point end = steady::now() + std::chrono::milliseconds(10);
+  while (steady::now() < end) {
+  }
+  Sample last = sample();
+  if (last.ticks <= begin.ticks) return c;
+
+  c.usable = true;
+  c.tscOrigin = begin.ticks;
+  c.nsOrigin = begin.ns;
+  c.nsPerTick = double(last.ns - begin.ns) / double(last.ticks - begin.ticks);
+#endif
+  return c;
+}
+}  // namespace
+
+const TscCalibration& tscCalibration() {
+  static const TscCalibration calibration = calibrate();
+  return calibration;
+}
+
+namespace {
+bool useTsc() {
+#ifdef HPP_UTIL_HAS_TSC
+  static const bool use = tscCalibration().usable;
+  return use;
+#else
+  return false;
+#endif
+}
+}  // namespace
+
+std::uint64_t rawStamp() {
+#ifdef HPP_UTIL_HAS_TSC
+  if (useTsc()) return __rdtsc();
+#endif
+  return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::int64_t rawStampToNanoseconds(std::uint64_t stamp) {
+  if (!useTsc()) return (std::int64_t)stamp;
+  const TscCalibration& c = tscCalibration();
+  return c.nsOrigin +
+         std::int64_t(double(std::int64_t(stamp - c.tscOrigin)) * c.nsPerTick);
+}
+
+#ifdef HPP_UTIL_TSC_CLOCK
+namespace {
+// Calibrate at startup rather than during the first measurement.
+const TscCalibration& calibrationAtStartup = tscCalibration();
+}  // namespace
+#endif
+}  // namespace internal
+}  // namespace debug
+}  // namespace hpp
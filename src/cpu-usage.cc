@@ -0,0 +1,66 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/cpu-usage.hh"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <time.h>
+#endif  // __linux__
+
+namespace hpp {
+namespace debug {
+#ifdef __linux__
+namespace {
+bool readClock(clockid_t clock, double& seconds) {
+  timespec ts;
+  if (clock_gettime(clock, &ts) != 0) return false;
+  seconds = (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+  return true;
+}
+}  // namespace
+
+bool CpuUsage::read(CpuUsage& usage) {
+  usage = CpuUsage{0, 0, 0, 0};
+  rusage ru;
+  if (!readClock(CLOCK_THREAD_CPUTIME_ID, usage.threadTime) ||
+      !readClock(CLOCK_PROCESS_CPUTIME_ID, usage.processTime) ||
+      getrusage(RUSAGE_THREAD, &ru) != 0)
+    return false;
+  usage.voluntarySwitches = ru.ru_nvcsw;
+  usage.involuntarySwitches = ru.ru_nivcsw;
+  return true;
+}
+#else
+bool CpuUsage::read(CpuUsage& usage) {
+  usage = CpuUsage{0, 0, 0, 0};
+  return false;
+}
+#endif  // __linux__
+}  // namespace debug
+}  // namespace hpp
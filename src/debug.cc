@@ -27,15 +27,18 @@
 
 #include "hpp/util/debug.hh"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>  // Need C++ 17 to remove this.
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 
 #include "config.h"
+#include "hpp/util/benchmark-environment.hh"
 #include "hpp/util/indent.hh"
 
 #ifndef HPP_LOGGINGDIR
@@ -58,10 +61,6 @@ namespace debug {
 static const char* ENV_LOGGINGDIR = "HPP_LOGGINGDIR";
 static const char* ENV_LOGGINGLEVEL = "HPP_LOGGINGLEVEL";
 
-static int verbosity = static_cast<int>(verbosityLevel::error);
-
-static int benchmarkEnabled = false;
-
 namespace {
 HPP_UTIL_LOCAL void makeDirectory(const std::string& filename) {
   using namespace boost::filesystem;
@@ -72,28 +71,48 @@ HPP_UTIL_LOCAL void makeDirectory(const std::string& filename) {
   boost::filesystem::create_directories(dirname);
 }
 
-struct SetVerbosityLevelFromEnvVar {
-  SetVerbosityLevelFromEnvVar() {
-    const char* levelStr = getenv(ENV_LOGGINGLEVEL);
-    if (levelStr) {
-      try {
-        int level = std::stoi(levelStr);
-        if (level >= 0) {
-          setVerbosityLevel(level);
-        } else {
-          std::cerr << ENV_LOGGINGLEVEL << " env var should not be negative."
-                    << std::endl;
-        }
-      } catch (std::invalid_argument& e) {
-        std::cerr << "Could not interpret " << ENV_LOGGINGLEVEL
-                  << " env var: " << e.what() << std::endl;
-      } catch (std::out_of_range& e) {
-        std::cerr << "Could not interpret " << ENV_LOGGINGLEVEL
-                  << " env var: " << e.what() << std::endl;
-      }
+// HPP_LOGGINGLEVEL contains the verbosity level and, optionally, the word
+// benchmark, separated by a comma.
+const char* benchmarkKeyword = "benchmark";
+
+bool benchmarkFromEnvVar() {
+  const char* levelStr = getenv(ENV_LOGGINGLEVEL);
+  return levelStr && std::strstr(levelStr, benchmarkKeyword) != NULL;
+}
+
+int verbosityLevelFromEnvVar() {
+  const char* env = getenv(ENV_LOGGINGLEVEL);
+  if (env) {
+    std::string levelStr(env);
+    std::size_t keyword = levelStr.find(benchmarkKeyword);
+    if (keyword != std::string::npos) {
+      levelStr.erase(keyword, std::strlen(benchmarkKeyword));
+      levelStr.erase(std::remove(levelStr.begin(), levelStr.end(), ','),
+                     levelStr.end());
+      if (levelStr.find_first_not_of(' ') == std::string::npos)
+        return verbosityLevel::error;
+    }
+    try {
+      int level = std::stoi(levelStr);
+      if (level >= 0) return level;
+      std::cerr << ENV_LOGGINGLEVEL << " env var should not be negative."
+                << std::endl;
+    } catch (std::invalid_argument& e) {
+      std::cerr << "Could not interpret " << ENV_LOGGINGLEVEL
+                << " env var: " << e.what() << std::endl;
+    } catch (std::out_of_range& e) {
+      std::cerr << "Could not interpret " << ENV_LOGGINGLEVEL
+                << " env var: " << e.what() << std::endl;
     }
   }
-};
+  return verbosityLevel::error;
+}
+
+// The environment variable is read on first access.
+int& verbosity() {
+  static int level = verbosityLevelFromEnvVar();
+  return level;
+}
 }  // namespace
 
 std::string getPrefix(const std::string& packageName) {
@@ -122,13 +141,58 @@ std::string getFilename(const std::string& filename,
   return res;
 }
 
-int getVerbosityLevel() { return verbosity; }
+int getVerbosityLevel() { return verbosity(); }
+
+void setVerbosityLevel(int level) { verbosity() = level; }
 
-void setVerbosityLevel(int level) { verbosity = level; }
+namespace internal {
+// Constant initialization, contrary to a call to benchmarkFromEnvVar.
+std::atomic<int> benchmarkState(BenchmarkUnknown);
 
-bool isBenchmarkEnabled() { return benchmarkEnabled; }
+int initBenchmarkState() {
+  int state = benchmarkFromEnvVar() ? BenchmarkEnabled : BenchmarkDisabled;
+  int expected = BenchmarkUnknown;
+  // Keep the state set by a concurrent call to enableBenchmark.
+  if (!benchmarkState.compare_exchange_strong(expected, state,
+                                              std::memory_order_relaxed))
+    state = expected;
+  return state;
+}
+}  // namespace internal
 
-void enableBenchmark(bool enable) { benchmarkEnabled = enable; }
+void enableBenchmark(bool enable) {
+  internal::benchmarkState.store(
+      enable ? internal::BenchmarkEnabled : internal::BenchmarkDisabled,
+      std::memory_order_relaxed);
+}
+
+thread_local const LogContext* LogContext::current_ = NULL;
+
+std::ostream& LogContext::printTags(std::ostream& os, bool& first) const {
+  if (parent_) parent_->printTags(os, first);
+  for (std::size_t i = 0; i < nTags_; ++i) {
+    if (!first) os << ' ';
+    first = false;
+    os << tags_[i].key << '=';
+    if (tags_[i].str)
+      os << tags_[i].str;
+    else
+      os << tags_[i].value;
+  }
+  return os;
+}
+
+std::ostream& LogContext::print(std::ostream& os) const {
+  const char* name = NULL;
+  for (const LogContext* c = this; c && !name; c = c->parent_) name = c->name_;
+  bool first = true;
+  os << '[';
+  if (name) {
+    os << name;
+    first = false;
+  }
+  return printTags(os, first) << ']';
+}
 
 Output::Output() {}
 
@@ -145,8 +209,9 @@ std::ostream& Output::writePrefix(std::ostream& stream, const Channel& channel,
                     1000};
 
   stream << std::put_time(std::localtime(&now), "[%F %T") << "." << std::setw(3)
-         << std::setfill('0') << millis << ']' << channel.label() << ':' << file
-         << ':' << line << ": ";
+         << std::setfill('0') << millis << ']';
+  if (const LogContext* context = LogContext::current()) context->print(stream);
+  stream << channel.label() << ':' << file << ':' << line << ": ";
   return stream;
 }
 
@@ -198,6 +263,15 @@ JournalOutput::JournalOutput(std::string filename)
 
 JournalOutput::~JournalOutput() {}
 
+void JournalOutput::setHeader(std::function<void(std::ostream&)> header) {
+  this->header = header;
+}
+
+void JournalOutput::open() {
+  stream.open(makeLogFile(*this).c_str());
+  if (header) header(stream);
+}
+
 // package name is set to ``hpp'' here so that
 // the journal can be shared between all hpp packages.
 // Splitting log into multiple files would make difficult
@@ -212,7 +286,7 @@ std::string JournalOutput::getFilename() const {
 
 void JournalOutput::write(const Channel& channel, char const* file, int line,
                           char const* function, const std::string& data) {
-  if (!stream.is_open()) stream.open(makeLogFile(*this).c_str());
+  if (!stream.is_open()) open();
 
   if (lastFunction != function) {
     if (!lastFunction.empty()) {
@@ -231,7 +305,7 @@ void JournalOutput::write(const Channel& channel, char const* file, int line,
 
 void JournalOutput::write(const Channel& channel, char const* file, int line,
                           char const* function, const std::stringstream& data) {
-  if (!stream.is_open()) stream.open(makeLogFile(*this).c_str());
+  if (!stream.is_open()) open();
   if (lastFunction != function) {
     if (!lastFunction.empty()) {
       writePrefix(stream, channel, file, line, function);
@@ -256,19 +330,20 @@ Logging::Logging()
       warning("WARNING", {&journal, &console}),
       notice("NOTICE", {&journal, &console}),
       info("INFO", {&journal}),
-      benchmark("BENCHMARK", {&benchmarkJournal}) {}
+      benchmark("BENCHMARK", {&benchmarkJournal}) {
+  benchmarkJournal.setHeader([](std::ostream& os) {
+    os << "benchmark environment\n" << BenchmarkEnvironment::read() << '\n';
+  });
+}
 
 Logging::~Logging() {}
 
+Logging& logging() {
+  // Never destroyed, so that logging from static destructors is safe.
+  static Logging* instance = new Logging;
+  return *instance;
+}
+
 }  // end of namespace debug.
 
 }  // end of namespace hpp.
-
-// Global variables definitions.
-namespace hpp {
-namespace debug {
-HPP_UTIL_DLLAPI Logging logging;
-
-HPP_UTIL_DLLAPI SetVerbosityLevelFromEnvVar setVerbosityLevelFromEnvVar;
-}  // end of namespace debug
-}  // end of namespace hpp
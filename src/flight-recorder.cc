@@ -0,0 +1,435 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "hpp/util/flight-recorder.hh"
+
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <hpp/util/clock.hh>
+#include <hpp/util/debug.hh>
+#include <hpp/util/exception-factory.hh>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+#ifdef HAVE_UNISTD_H
+#include <fcntl.h>
+#include <unistd.h>
+#else
+static int getpid() { return 0; }
+#endif  // HAVE_UNISTD_H
+
+namespace hpp {
+namespace debug {
+namespace internal {
+std::atomic<bool> flightTriggersArmed(false);
+}  // namespace internal
+
+namespace {
+constexpr std::memory_order relaxed = std::memory_order_relaxed;
+
+// The type of the event is stored in the lowest bits of the address of the
+// ScopeId.
+static_assert(alignof(ScopeId) >= 4, "Unexpected alignment of ScopeId.");
+constexpr std::uintptr_t typeMask = 3;
+
+// The fields are atomic so that a ring can be read while its thread
+// overwrites it.
+struct Slot {
+  std::atomic<std::uint64_t> stamp;
+  std::atomic<std::uint64_t> payload;
+  std::atomic<std::uintptr_t> id;
+};
+
+// Rings form a list which is only extended, so that it can be read from a
+// signal handler. A ring is released when its thread exits and reused by a
+// new thread, events included.
+struct Ring {
+  Ring(std::size_t capacity, std::size_t tid)
+      : slots(new Slot[capacity]()),
+        mask(capacity - 1),
+        tid(tid),
+        head(0),
+        started(0),
+        inUse(true),
+        next(NULL) {}
+
+  Slot* const slots;
+  const std::uint64_t mask;
+  const std::size_t tid;
+  // Number of events recorded in the ring.
+  std::atomic<std::uint64_t> head;
+  // Number of events whose recording started, head + 1 while an event is
+  // being written.
+  std::atomic<std::uint64_t> started;
+  std::atomic<bool> inUse;
+  Ring* next;
+};
+
+std::atomic<Ring*> rings(NULL);
+std::atomic<std::size_t> ringCount(0);
+std::atomic<std::size_t> ringCapacity(4096);
+
+// Initial exec TLS model, so that reading it from the signal handler does
+// not allocate.
+thread_local Ring* currentRing __attribute__((tls_model("initial-exec"))) =
+    NULL;
+
+struct RingOwner {
+  ~RingOwner() {
+    if (currentRing) currentRing->inUse.store(false, std::memory_order_release);
+    currentRing = NULL;
+  }
+};
+
+Ring* acquireRing() {
+  thread_local RingOwner owner;
+  (void)owner;
+  const std::size_t capacity = ringCapacity.load(relaxed);
+  for (Ring* ring = rings.load(std::memory_order_acquire); ring != NULL;
+       ring = ring->next) {
+    bool free = false;
+    if (ring->mask + 1 == capacity &&
+        ring->inUse.compare_exchange_strong(free, true,
+                                            std::memory_order_acquire))
+      return currentRing = ring;
+  }
+  Ring* ring = new Ring(capacity, ringCount.fetch_add(1) + 1);
+  ring->next = rings.load(relaxed);
+  while (!rings.compare_exchange_weak(ring->next, ring,
+                                      std::memory_order_release)) {
+  }
+  return currentRing = ring;
+}
+
+// Buffered output to a file descriptor or a stream. Writing to a file
+// descriptor neither locks nor allocates, so that it can be used from a
+// signal handler.
+class Writer {
+ public:
+  explicit Writer(int fd) : fd_(fd), os_(NULL), size_(0) {}
+  explicit Writer(std::ostream& os) : fd_(-1), os_(&os), size_(0) {}
+  ~Writer() { flush(); }
+
+  void put(char c) {
+    if (size_ == sizeof(buffer_)) flush();
+    buffer_[size_++] = c;
+  }
+
+  void put(const char* str) {
+    for (; *str != '\0'; ++str) put(*str);
+  }
+
+  void put(std::uint64_t value) {
+    char digits[20];
+    int n = 0;
+    do {
+      digits[n++] = char('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    while (n > 0) put(digits[--n]);
+  }
+
+  void putString(const char* str) {
+    put('"');
+    for (; *str != '\0'; ++str) {
+      if (*str == '"' || *str == '\\') {
+        put('\\');
+        put(*str);
+      } else if ((unsigned char)*str < 0x20)
+        put(' ');
+      else
+        put(*str);
+    }
+    put('"');
+  }
+
+  // Nanoseconds written as microseconds.
+  void putMicroseconds(std::int64_t ns) {
+    if (ns < 0) ns = 0;
+    put(std::uint64_t(ns / 1000));
+    put('.');
+    const int frac = int(ns % 1000);
+    put(char('0' + frac / 100));
+    put(char('0' + frac / 10 % 10));
+    put(char('0' + frac % 10));
+  }
+
+  void flush() {
+    if (os_ != NULL)
+      os_->write(buffer_, std::streamsize(size_));
+#ifdef HAVE_UNISTD_H
+    else {
+      const char* data = buffer_;
+      std::size_t size = size_;
+      while (size > 0) {
+        const ssize_t n = ::write(fd_, data, size);
+        if (n <= 0) break;
+        data += n;
+        size -= std::size_t(n);
+      }
+    }
+#endif
+    size_ = 0;
+  }
+
+ private:
+  const int fd_;
+  std::ostream* const os_;
+  std::size_t size_;
+  char buffer_[4096];
+};
+
+void writeRings(Writer& w) {
+  const std::uint64_t pid = std::uint64_t(getpid());
+  w.put("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  const char* separator = "\n";
+  for (const Ring* ring = rings.load(std::memory_order_acquire); ring != NULL;
+       ring = ring->next) {
+    const std::uint64_t size = ring->mask + 1;
+    const std::uint64_t end = ring->head.load(std::memory_order_acquire);
+    for (std::uint64_t i = (end > size ? end - size : 0); i < end; ++i) {
+      const Slot& slot = ring->slots[i & ring->mask];
+      const std::uint64_t stamp = slot.stamp.load(relaxed);
+      const std::uint64_t payload = slot.payload.load(relaxed);
+      const std::uintptr_t id = slot.id.load(relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // The slot was overwritten by event i + size.
+      if (ring->started.load(relaxed) > i + size) continue;
+      const ScopeId* scope = reinterpret_cast<const ScopeId*>(id & ~typeMask);
+      const char* phase;
+      switch (id & typeMask) {
+        case internal::FlightBegin:
+          phase = "B";
+          break;
+        case internal::FlightEnd:
+          phase = "E";
+          break;
+        default:
+          phase = "i\",\"s\":\"t";
+          break;
+      }
+      w.put(separator);
+      w.put("{\"name\":");
+      w.putString(scope->name());
+      w.put(",\"ph\":\"");
+      w.put(phase);
+      w.put("\",\"pid\":");
+      w.put(pid);
+      w.put(",\"tid\":");
+      w.put(std::uint64_t(ring->tid));
+      w.put(",\"ts\":");
+      w.putMicroseconds(internal::rawStampToNanoseconds(stamp));
+      if ((id & typeMask) != internal::FlightEnd) {
+        w.put(",\"args\":{\"payload\":");
+        w.put(payload);
+        w.put('}');
+      }
+      w.put('}');
+      separator = ",\n";
+    }
+  }
+  w.put("\n]}\n");
+}
+
+// Prefix of the automatic exports, in a fixed buffer so that the signal
+// handler does not allocate.
+char dumpPrefix[1024] = "";
+std::atomic<unsigned> dumpCount(0);
+std::mutex configMutex;
+
+// configMutex must be locked.
+void initDumpPrefix() {
+  if (dumpPrefix[0] != '\0') return;
+  const std::string prefix =
+      getFilename("flight-record." + std::to_string(getpid()), "");
+  std::strncpy(dumpPrefix, prefix.c_str(), sizeof(dumpPrefix) - 1);
+}
+
+// Write the rings to the next automatic export file.
+bool dump() {
+#ifdef HAVE_UNISTD_H
+  char filename[sizeof(dumpPrefix) + 32];
+  std::size_t n = std::strlen(dumpPrefix);
+  std::memcpy(filename, dumpPrefix, n);
+  filename[n++] = '.';
+  char digits[10];
+  int d = 0;
+  unsigned count = dumpCount.fetch_add(1);
+  do {
+    digits[d++] = char('0' + count % 10);
+    count /= 10;
+  } while (count != 0);
+  while (d > 0) filename[n++] = digits[--d];
+  std::memcpy(filename + n, ".json", 6);
+
+  const int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return false;
+  {
+    Writer w(fd);
+    writeRings(w);
+  }
+  ::close(fd);
+  return true;
+#else
+  return false;
+#endif
+}
+
+struct Trigger {
+  std::atomic<const ScopeId*> id;
+  std::atomic<std::uint64_t> threshold;
+};
+
+constexpr std::size_t maxTriggers = 16;
+Trigger triggers[maxTriggers];
+
+#ifdef HAVE_UNISTD_H
+const int crashSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+constexpr std::size_t nCrashSignals =
+    sizeof(crashSignals) / sizeof(crashSignals[0]);
+struct sigaction previousActions[nCrashSignals];
+std::atomic<bool> crashed(false);
+
+void crashHandler(int signal) {
+  if (!crashed.exchange(true)) dump();
+  for (std::size_t i = 0; i < nCrashSignals; ++i) {
+    if (crashSignals[i] == signal) {
+      sigaction(signal, &previousActions[i], NULL);
+      break;
+    }
+  }
+  // The signal is delivered again when the handler returns if it was caused
+  // by the faulting instruction, raise it for the other cases.
+  raise(signal);
+}
+#endif  // HAVE_UNISTD_H
+}  // namespace
+
+namespace internal {
+std::uint64_t flightRecord(const ScopeId& id, FlightEventType type,
+                           std::uint64_t payload) {
+  const std::uint64_t time = rawStamp();
+  Ring* ring = currentRing;
+  if (ring == NULL) ring = acquireRing();
+  const std::uint64_t h = ring->head.load(relaxed);
+  Slot& slot = ring->slots[h & ring->mask];
+  // Readers seeing one of the stores below also see that the recording of
+  // the event started, hence know that the slot is being overwritten.
+  ring->started.store(h + 1, relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.stamp.store(time, relaxed);
+  slot.payload.store(payload, relaxed);
+  slot.id.store(reinterpret_cast<std::uintptr_t>(&id) | type, relaxed);
+  ring->head.store(h + 1, std::memory_order_release);
+  return time;
+}
+
+void checkFlightTrigger(const ScopeId& id, std::uint64_t duration) {
+  for (std::size_t i = 0; i < maxTriggers; ++i) {
+    const ScopeId* expected = &id;
+    if (triggers[i].id.load(std::memory_order_acquire) == expected &&
+        duration > triggers[i].threshold.load(relaxed) &&
+        triggers[i].id.compare_exchange_strong(expected, NULL)) {
+      if (!dump())
+        hppLogf(error, "Failed to write the flight record of {}", id.name());
+    }
+  }
+}
+}  // namespace internal
+
+void setFlightRecorderCapacity(std::size_t eventsPerThread) {
+  std::size_t capacity = 1;
+  while (capacity < eventsPerThread) capacity <<= 1;
+  ringCapacity.store(capacity);
+}
+
+std::ostream& writeFlightRecord(std::ostream& os) {
+  Writer w(os);
+  writeRings(w);
+  return os;
+}
+
+bool writeFlightRecord(const std::string& filename) {
+  std::ofstream file(filename.c_str());
+  writeFlightRecord(file);
+  file.close();
+  return bool(file);
+}
+
+void setFlightRecordPrefix(const std::string& prefix) {
+  if (prefix.empty() || prefix.size() >= sizeof(dumpPrefix))
+    HPP_THROW(std::invalid_argument,
+              "Invalid flight record prefix \"" << prefix << '"');
+  std::lock_guard<std::mutex> lock(configMutex);
+  std::memcpy(dumpPrefix, prefix.c_str(), prefix.size() + 1);
+}
+
+bool dumpFlightRecordOnCrash() {
+#ifdef HAVE_UNISTD_H
+  // Calibrate the clock now rather than in the signal handler.
+  internal::rawStampToNanoseconds(internal::rawStamp());
+  std::lock_guard<std::mutex> lock(configMutex);
+  initDumpPrefix();
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = crashHandler;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_ONSTACK;
+  for (std::size_t i = 0; i < nCrashSignals; ++i)
+    if (sigaction(crashSignals[i], &action, &previousActions[i]) != 0)
+      return false;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void dumpFlightRecordWhenLonger(const ScopeId& id, double seconds) {
+  if (!(seconds > 0))
+    HPP_THROW(std::invalid_argument,
+              "The duration of trigger " << id.name() << " must be positive");
+  std::uint64_t threshold = std::uint64_t(seconds * 1e9);
+  // Time stamps are ticks of the time stamp counter if it is usable.
+  if (internal::tscCalibration().usable)
+    threshold = std::uint64_t(seconds * 1e9 /
+                              internal::tscCalibration().nsPerTick);
+  std::lock_guard<std::mutex> lock(configMutex);
+  initDumpPrefix();
+  for (std::size_t i = 0; i < maxTriggers; ++i) {
+    if (triggers[i].id.load(relaxed) == NULL) {
+      triggers[i].threshold.store(threshold, relaxed);
+      triggers[i].id.store(&id, std::memory_order_release);
+      internal::flightTriggersArmed.store(true);
+      return;
+    }
+  }
+  HPP_THROW(std::runtime_error, "Too many flight record triggers");
+}
+}  // namespace debug
+}  // namespace hpp
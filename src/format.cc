@@ -0,0 +1,197 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/format.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define HPP_UTIL_HAS_TO_CHARS
+#ifdef __cpp_lib_to_chars
+#define HPP_UTIL_HAS_FLOATING_TO_CHARS
+#endif  // __cpp_lib_to_chars
+#endif  // __has_include(<charconv>)
+#endif  // __cplusplus >= 201703L && defined(__has_include)
+
+namespace hpp {
+namespace debug {
+namespace format {
+namespace {
+thread_local std::string threadBuffer;
+thread_local bool threadBufferInUse = false;
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+#ifndef HPP_UTIL_HAS_TO_CHARS
+// Write v at the end of [begin, end) and return the first written character.
+char* writeBackward(char* end, unsigned long long v, unsigned base) {
+  static const char digits[] = "0123456789abcdef";
+  do {
+    *--end = digits[v % base];
+    v /= base;
+  } while (v != 0);
+  return end;
+}
+#endif  // HPP_UTIL_HAS_TO_CHARS
+
+void appendUnsigned(std::string& out, unsigned long long v, unsigned base) {
+  char buf[24];
+#ifdef HPP_UTIL_HAS_TO_CHARS
+  std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), v, (int)base);
+  out.append(buf, r.ptr);
+#else
+  char* end = buf + sizeof(buf);
+  out.append(writeBackward(end, v, base), end);
+#endif  // HPP_UTIL_HAS_TO_CHARS
+}
+
+void appendPrintf(std::string& out, const Spec& spec, double v) {
+  char type = spec.type == 'f' || spec.type == 'e' ? spec.type : 'g';
+  char fmt[] = {'%', '.', '*', type, '\0'};
+  int precision = spec.precision;
+  if (precision < 0) precision = (spec.type == '\0' ? 15 : 6);
+  char buf[64];
+  int n = std::snprintf(buf, sizeof(buf), fmt, precision, v);
+  if (spec.type == '\0' && spec.precision < 0 && std::strtod(buf, NULL) != v)
+    n = std::snprintf(buf, sizeof(buf), fmt, 17, v);
+  if (n < 0) return;
+  if ((std::size_t)n < sizeof(buf)) {
+    out.append(buf, (std::size_t)n);
+    return;
+  }
+  std::size_t size = out.size();
+  out.resize(size + (std::size_t)n + 1);
+  std::snprintf(&out[size], (std::size_t)n + 1, fmt, precision, v);
+  out.resize(size + (std::size_t)n);
+}
+}  // namespace
+
+const char* appendLiteral(std::string& out, const char* fmt, Spec& spec) {
+  const char* begin = fmt;
+  for (; *fmt != '\0'; ++fmt) {
+    if (*fmt != '{' && *fmt != '}') continue;
+    out.append(begin, fmt);
+    if (fmt[1] == *fmt || *fmt == '}') {
+      // Escaped brace. A single closing brace is rejected by countFields.
+      begin = (fmt[1] == *fmt) ? ++fmt : fmt + 1;
+      continue;
+    }
+    ++fmt;
+    spec.precision = -1;
+    spec.type = '\0';
+    if (*fmt == ':') {
+      ++fmt;
+      if (*fmt == '.') {
+        ++fmt;
+        spec.precision = 0;
+        for (; isDigit(*fmt); ++fmt)
+          spec.precision = 10 * spec.precision + (*fmt - '0');
+      }
+      if (internal::isType(*fmt)) spec.type = *fmt++;
+    }
+    if (*fmt == '}') ++fmt;
+    return fmt;
+  }
+  out.append(begin, fmt);
+  return NULL;
+}
+
+void append(std::string& out, const Spec& spec, long long v) {
+  unsigned base = (spec.type == 'x' ? 16 : 10);
+  if (v < 0) {
+    out += '-';
+    appendUnsigned(out, 0ULL - (unsigned long long)v, base);
+  } else
+    appendUnsigned(out, (unsigned long long)v, base);
+}
+
+void append(std::string& out, const Spec& spec, unsigned long long v) {
+  appendUnsigned(out, v, spec.type == 'x' ? 16 : 10);
+}
+
+void append(std::string& out, const Spec& spec, double v) {
+#ifdef HPP_UTIL_HAS_FLOATING_TO_CHARS
+  char buf[64];
+  std::to_chars_result r;
+  if (spec.precision < 0 && (spec.type == '\0' || spec.type == 'x'))
+    r = std::to_chars(buf, buf + sizeof(buf), v);
+  else {
+    std::chars_format format = spec.type == 'f'   ? std::chars_format::fixed
+                               : spec.type == 'e' ? std::chars_format::scientific
+                                                  : std::chars_format::general;
+    r = std::to_chars(buf, buf + sizeof(buf), v, format,
+                      spec.precision < 0 ? 6 : spec.precision);
+  }
+  if (r.ec == std::errc()) {
+    out.append(buf, r.ptr);
+    return;
+  }
+#endif  // HPP_UTIL_HAS_FLOATING_TO_CHARS
+  appendPrintf(out, spec, v);
+}
+
+void append(std::string& out, const Spec&, bool v) {
+  out += (v ? "true" : "false");
+}
+
+void append(std::string& out, const Spec&, char v) { out += v; }
+
+void append(std::string& out, const Spec& spec, const char* v) {
+  if (v == NULL) v = "(null)";
+  if (spec.precision < 0)
+    out += v;
+  else
+    out.append(v, std::min(std::strlen(v), (std::size_t)spec.precision));
+}
+
+void append(std::string& out, const Spec& spec, const std::string& v) {
+  if (spec.precision < 0)
+    out += v;
+  else
+    out.append(v, 0, (std::size_t)spec.precision);
+}
+
+Buffer::Buffer() : str_(&local_) {
+  if (!threadBufferInUse) {
+    threadBufferInUse = true;
+    str_ = &threadBuffer;
+    str_->clear();
+  }
+}
+
+Buffer::~Buffer() {
+  if (str_ != &local_) threadBufferInUse = false;
+}
+}  // namespace format
+}  // namespace debug
+}  // namespace hpp
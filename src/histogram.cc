@@ -0,0 +1,175 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/histogram.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/util/serialization.hh>
+#include <ostream>
+#include <stdexcept>
+
+namespace hpp {
+namespace debug {
+namespace {
+constexpr std::memory_order relaxed = std::memory_order_relaxed;
+}  // namespace
+
+Histogram::Histogram(unsigned precision, unsigned range)
+    : precision_(precision), range_(range), size_(0), counts_(NULL) {
+  if (precision < 1 || precision > 16 || range <= precision || range > 64)
+    HPP_THROW(std::invalid_argument,
+              "Invalid histogram precision " << precision << " and range "
+                                             << range);
+  const std::size_t half = std::size_t(1) << (precision - 1);
+  size_ = 2 * half + (range - precision) * half;
+  counts_ = new std::atomic<count_type>[size_];
+  reset();
+}
+
+Histogram::Histogram(const Histogram& other)
+    : precision_(other.precision_),
+      range_(other.range_),
+      size_(other.size_),
+      counts_(new std::atomic<count_type>[other.size_]) {
+  for (std::size_t i = 0; i < size_; ++i)
+    counts_[i].store(other.counts_[i].load(relaxed), relaxed);
+}
+
+Histogram& Histogram::operator=(const Histogram& other) {
+  if (this == &other) return *this;
+  if (size_ != other.size_) {
+    delete[] counts_;
+    counts_ = new std::atomic<count_type>[other.size_];
+    size_ = other.size_;
+  }
+  precision_ = other.precision_;
+  range_ = other.range_;
+  for (std::size_t i = 0; i < size_; ++i)
+    counts_[i].store(other.counts_[i].load(relaxed), relaxed);
+  return *this;
+}
+
+Histogram::~Histogram() { delete[] counts_; }
+
+void Histogram::merge(const Histogram& other) {
+  if (precision_ != other.precision_ || range_ != other.range_)
+    HPP_THROW(std::invalid_argument,
+              "Cannot merge histograms of different precision or range");
+  for (std::size_t i = 0; i < size_; ++i)
+    counts_[i].store(
+        counts_[i].load(relaxed) + other.counts_[i].load(relaxed), relaxed);
+}
+
+void Histogram::reset() {
+  for (std::size_t i = 0; i < size_; ++i) counts_[i].store(0, relaxed);
+}
+
+Histogram::count_type Histogram::count() const {
+  count_type n = 0;
+  for (std::size_t i = 0; i < size_; ++i) n += counts_[i].load(relaxed);
+  return n;
+}
+
+double Histogram::percentile(double p) const {
+  const count_type n = count();
+  if (n == 0) return 0;
+  p = std::min(std::max(p, 0.), 100.);
+  const count_type rank =
+      std::max(count_type(1), (count_type)std::ceil(p / 100 * (double)n));
+  count_type cumulated = 0;
+  for (std::size_t i = 0; i < size_; ++i) {
+    cumulated += counts_[i].load(relaxed);
+    if (cumulated >= rank) return (double)upperBound(i) * 1e-9;
+  }
+  return (double)upperBound(size_ - 1) * 1e-9;
+}
+
+std::uint64_t Histogram::upperBound(std::size_t index) const {
+  const std::uint64_t half = std::uint64_t(1) << (precision_ - 1);
+  if (index < 2 * half) return index;
+  const std::uint64_t k = index - 2 * half;
+  const unsigned shift = (unsigned)(k / half) + 1;
+  const std::uint64_t top = k % half + half;
+  if (shift + precision_ >= 64 && top + 1 == 2 * half) return UINT64_MAX;
+  return ((top + 1) << shift) - 1;
+}
+
+std::ostream& Histogram::print(std::ostream& os) const {
+  return os << "p50 " << percentile(50) << ", p90 " << percentile(90)
+            << ", p99 " << percentile(99) << ", p999 " << percentile(99.9);
+}
+
+template <class Archive>
+void Histogram::save(Archive& ar, const unsigned int version) const {
+  using hpp::serialization::make_nvp;
+  (void)version;
+  ar& make_nvp("precision", precision_);
+  ar& make_nvp("range", range_);
+  // Only the non empty buckets are saved, as most of them are empty.
+  std::uint64_t n = 0;
+  for (std::size_t i = 0; i < size_; ++i)
+    if (counts_[i].load(relaxed) != 0) ++n;
+  ar& make_nvp("buckets", n);
+  for (std::size_t i = 0; i < size_; ++i) {
+    count_type count = counts_[i].load(relaxed);
+    if (count == 0) continue;
+    std::uint64_t index = i;
+    ar& make_nvp("index", index);
+    ar& make_nvp("count", count);
+  }
+}
+
+template <class Archive>
+void Histogram::load(Archive& ar, const unsigned int version) {
+  using hpp::serialization::make_nvp;
+  (void)version;
+  unsigned precision, range;
+  ar& make_nvp("precision", precision);
+  ar& make_nvp("range", range);
+  if (precision != precision_ || range != range_)
+    *this = Histogram(precision, range);
+  else
+    reset();
+  std::uint64_t n;
+  ar& make_nvp("buckets", n);
+  for (std::uint64_t k = 0; k < n; ++k) {
+    std::uint64_t index;
+    count_type count;
+    ar& make_nvp("index", index);
+    ar& make_nvp("count", count);
+    if (index >= size_)
+      HPP_THROW(std::invalid_argument, "Invalid histogram bucket " << index);
+    counts_[index].store(count, relaxed);
+  }
+}
+
+HPP_SERIALIZATION_SPLIT_IMPLEMENT(Histogram);
+}  // namespace debug
+}  // namespace hpp
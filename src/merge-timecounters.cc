@@ -0,0 +1,107 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+// Merge the time counters saved by several processes with saveTimeCounters.
+
+#include <cstdlib>
+#include <cstring>
+#include <hpp/util/timer.hh>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace hpp::debug;
+
+namespace {
+const char* usage =
+    "Usage: hpp-util-merge-timecounters [options] FILE...\n"
+    "Merge the time counters of the same name saved in the files and write\n"
+    "the table of the merged counters.\n"
+    "Options:\n"
+    "  --output=FILE   also save the merged counters in FILE, which can be\n"
+    "                  merged again\n"
+    "  --verbose       write all the statistics of each merged counter\n";
+
+const int errorStatus = 2;
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* output = NULL;
+  bool verbose = false;
+  std::vector<const char*> files;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--help") == 0) {
+      std::cout << usage;
+      return EXIT_SUCCESS;
+    }
+    if (std::strncmp(argv[i], "--output=", 9) == 0 && argv[i][9] != '\0') {
+      output = argv[i] + 9;
+      continue;
+    }
+    if (std::strcmp(argv[i], "--verbose") == 0) {
+      verbose = true;
+      continue;
+    }
+    if (std::strncmp(argv[i], "--", 2) == 0) {
+      std::cerr << "Unknown option " << argv[i] << '\n' << usage;
+      return errorStatus;
+    }
+    files.push_back(argv[i]);
+  }
+  if (files.empty()) {
+    std::cerr << usage;
+    return errorStatus;
+  }
+
+  try {
+    std::map<std::string, std::unique_ptr<TimeCounter>> merged;
+    for (const char* file : files) {
+      // The loaded counters are destroyed at the end of the iteration, so
+      // that only the merged ones remain registered.
+      for (std::unique_ptr<TimeCounter>& tc : loadTimeCounters(file)) {
+        std::unique_ptr<TimeCounter>& m = merged[tc->name()];
+        if (m)
+          m->merge(*tc);
+        else
+          m = std::move(tc);
+      }
+    }
+    dumpTimeCounters(std::cout);
+    if (verbose)
+      for (const auto& m : merged) std::cout << *m.second << '\n';
+    if (output != NULL && !saveTimeCounters(output)) {
+      std::cerr << "Failed to write " << output << std::endl;
+      return errorStatus;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return errorStatus;
+  }
+  return EXIT_SUCCESS;
+}
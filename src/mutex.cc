@@ -0,0 +1,185 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/mutex.hh"
+
+#include <limits>
+#include <ostream>
+
+namespace hpp {
+namespace debug {
+namespace {
+typedef DefaultClock clock_type;
+constexpr std::memory_order relaxed = std::memory_order_relaxed;
+
+double secondsSince(const clock_type::time_point& start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+void add(std::atomic<double>& a, double v) {
+  double current = a.load(relaxed);
+  while (!a.compare_exchange_weak(current, current + v, relaxed)) {
+  }
+}
+
+void keepMin(std::atomic<double>& a, double v) {
+  double current = a.load(relaxed);
+  while (v < current && !a.compare_exchange_weak(current, v, relaxed)) {
+  }
+}
+
+void keepMax(std::atomic<double>& a, double v) {
+  double current = a.load(relaxed);
+  while (v > current && !a.compare_exchange_weak(current, v, relaxed)) {
+  }
+}
+}  // namespace
+
+LockCounter::LockCounter(const std::string& name)
+    : TimeCounterBase(name),
+      acquisitions_(0),
+      shared_(0),
+      failedTries_(0),
+      contended_(0),
+      waitTime_(0),
+      minWait_(std::numeric_limits<double>::max()),
+      maxWait_(0) {
+  publish();
+}
+
+LockCounter::~LockCounter() { unregister(); }
+
+void LockCounter::waited(double seconds, bool shared) {
+  if (shared)
+    acquiredShared();
+  else
+    acquired();
+  contended_.fetch_add(1, relaxed);
+  add(waitTime_, seconds);
+  keepMin(minWait_, seconds);
+  keepMax(maxWait_, seconds);
+  waits_.record(seconds);
+}
+
+unsigned long LockCounter::acquisitions() const {
+  return acquisitions_.load(relaxed) + shared_.load(relaxed);
+}
+
+unsigned long LockCounter::sharedAcquisitions() const {
+  return shared_.load(relaxed);
+}
+
+unsigned long LockCounter::contended() const {
+  return contended_.load(relaxed);
+}
+
+unsigned long LockCounter::failedTries() const {
+  return failedTries_.load(relaxed);
+}
+
+double LockCounter::waitTime() const { return waitTime_.load(relaxed); }
+
+double LockCounter::percentile(double p) const {
+  const unsigned long n = acquisitions(), c = contended();
+  if (c == 0) return 0;
+  // The uncontended acquisitions are the smallest waits.
+  const double uncontended = n > c ? double(n - c) : 0;
+  const double rank = p / 100 * (uncontended + double(c));
+  if (rank <= uncontended) return 0;
+  return waits_.percentile(100 * (rank - uncontended) / double(c));
+}
+
+void LockCounter::reset() {
+  acquisitions_ = 0;
+  shared_ = 0;
+  failedTries_ = 0;
+  contended_ = 0;
+  waitTime_ = 0;
+  minWait_ = std::numeric_limits<double>::max();
+  maxWait_ = 0;
+  waits_.reset();
+}
+
+LockCounter::Snapshot LockCounter::snapshot() const {
+  Snapshot s;
+  s.name = n_;
+  s.count = acquisitions();
+  s.p99 = percentile(99);
+  s.cpuRatio = std::numeric_limits<double>::quiet_NaN();
+  const unsigned long c = contended();
+  s.totalTime = waitTime();
+  s.min = (s.count > c || c == 0) ? 0 : minWait_.load(relaxed);
+  s.mean = (s.count > 0) ? s.totalTime / (double)s.count : 0;
+  s.max = maxWait_.load(relaxed);
+  return s;
+}
+
+std::ostream& LockCounter::print(std::ostream& os) const {
+  const unsigned long n = acquisitions(), c = contended();
+  os << "Lock Counter " << n_ << ": " << n << " acquisitions";
+  if (sharedAcquisitions() > 0)
+    os << " (" << sharedAcquisitions() << " shared)";
+  os << ", " << c << " contended";
+  if (n > 0) os << " (" << 100. * double(c) / double(n) << "%)";
+  if (failedTries() > 0) os << ", " << failedTries() << " failed try_lock";
+  if (c == 0) return os;
+  const double wait = waitTime();
+  os << ", wait " << wait << ", [ " << minWait_.load(relaxed) << ", "
+     << wait / double(c) << ", " << maxWait_.load(relaxed) << "], ";
+  return waits_.print(os);
+}
+
+std::ostream& operator<<(std::ostream& os, const LockCounter& lc) {
+  return lc.print(os);
+}
+
+LockCounter& defaultLockCounter() {
+  // Leaked, as mutexes may be locked from static destructors.
+  static LockCounter* instance = new LockCounter("unnamed mutexes");
+  return *instance;
+}
+
+void ProfiledMutex::lockContended() {
+  const clock_type::time_point start = clock_type::now();
+  mutex_.lock();
+  counter_.waited(secondsSince(start), false);
+}
+
+void ProfiledSharedMutex::lockContended() {
+  const clock_type::time_point start = clock_type::now();
+  mutex_.lock();
+  counter_.waited(secondsSince(start), false);
+}
+
+void ProfiledSharedMutex::lockSharedContended() {
+  const clock_type::time_point start = clock_type::now();
+  mutex_.lock_shared();
+  counter_.waited(secondsSince(start), true);
+}
+}  // end of namespace debug
+}  // end of namespace hpp
@@ -0,0 +1,150 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/perf-counters.hh"
+
+#include <atomic>
+#include <cstring>
+
+#include "hpp/util/debug.hh"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif  // __linux__
+
+namespace hpp {
+namespace debug {
+namespace {
+#ifdef __linux__
+const std::uint64_t configs[PerfCounters::NbEvents] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+struct ThreadGroup {
+  /// File descriptor of the group leader, -1 if no event is available.
+  int leader;
+  int fds[PerfCounters::NbEvents];
+  /// Position of each event in the group, -1 if not available.
+  int positions[PerfCounters::NbEvents];
+  int size;
+  unsigned mask;
+
+  ThreadGroup() : leader(-1), size(0), mask(0) {
+    int error = 0;
+    for (int e = 0; e < PerfCounters::NbEvents; ++e) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[e];
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds[e] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+      if (fds[e] < 0) {
+        error = errno;
+        positions[e] = -1;
+        continue;
+      }
+      if (leader < 0) leader = fds[e];
+      positions[e] = size++;
+      mask |= 1u << e;
+    }
+    if (mask != (1u << PerfCounters::NbEvents) - 1) {
+      static std::atomic<bool> warned(false);
+      if (!warned.exchange(true))
+        hppLogf(warning,
+                "Some hardware performance counters are unavailable: {}. "
+                "See /proc/sys/kernel/perf_event_paranoid.",
+                std::strerror(error));
+    }
+  }
+
+  ~ThreadGroup() {
+    for (int e = 0; e < PerfCounters::NbEvents; ++e)
+      if (fds[e] >= 0) close(fds[e]);
+  }
+};
+
+ThreadGroup& threadGroup() {
+  thread_local ThreadGroup group;
+  return group;
+}
+#endif  // __linux__
+}  // namespace
+
+bool PerfCounters::read(Sample& sample) {
+  sample.mask = 0;
+#ifdef __linux__
+  ThreadGroup& group = threadGroup();
+  if (group.leader < 0) return false;
+  std::uint64_t buffer[1 + NbEvents];
+  ssize_t n = ::read(group.leader, buffer, sizeof(buffer));
+  if (n < (ssize_t)sizeof(std::uint64_t) ||
+      buffer[0] != (std::uint64_t)group.size)
+    return false;
+  for (int e = 0; e < NbEvents; ++e)
+    sample.values[e] =
+        (group.positions[e] >= 0) ? buffer[1 + group.positions[e]] : 0;
+  sample.mask = group.mask;
+  return true;
+#else
+  for (int e = 0; e < NbEvents; ++e) sample.values[e] = 0;
+  return false;
+#endif  // __linux__
+}
+
+bool PerfCounters::isAvailable(Event e) {
+#ifdef __linux__
+  return (threadGroup().mask & (1u << e)) != 0;
+#else
+  (void)e;
+  return false;
+#endif  // __linux__
+}
+
+const char* PerfCounters::name(Event e) {
+  switch (e) {
+    case Cycles:
+      return "cycles";
+    case Instructions:
+      return "instructions";
+    case CacheMisses:
+      return "cache misses";
+    case BranchMisses:
+      return "branch misses";
+    default:
+      return "unknown";
+  }
+}
+}  // namespace debug
+}  // namespace hpp
@@ -0,0 +1,562 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/profiler.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <hpp/util/debug.hh>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/util/indent.hh>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "config.h"
+
+// The sampling profiler relies on SIGPROF, setitimer and the signal context.
+#if defined(HAVE_UNISTD_H) && defined(__linux__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+namespace hpp {
+namespace debug {
+namespace internal {
+struct ProfileNode {
+  ProfileNode(std::size_t id, ProfileNode* parent)
+      : id(id), parent(parent), count(0), inclusive(0), samples(0) {}
+
+  ~ProfileNode() {
+    for (ProfileNode* child : children) delete child;
+  }
+
+  const std::size_t id;
+  ProfileNode* const parent;
+  // Only written by the thread owning the tree.
+  std::atomic<unsigned long> count;
+  std::atomic<double> inclusive;
+  // Only written by the sampling signal handler, on the owning thread.
+  std::atomic<unsigned long> samples;
+  // Only modified by the thread owning the tree, with the tree mutex locked.
+  std::vector<ProfileNode*> children;
+};
+}  // namespace internal
+
+namespace {
+using internal::ProfileNode;
+
+constexpr std::memory_order relaxed = std::memory_order_relaxed;
+
+/// Samples of a thread, written by the signal handler and read by the
+/// reports.
+struct SampleRing {
+  struct Sample {
+    ProfileNode* node;
+    std::uintptr_t ip;
+  };
+
+  explicit SampleRing(std::size_t capacity)
+      : samples(capacity), head(0), tail(0), dropped(0) {}
+
+  // Called from the signal handler: no allocation and no lock.
+  void push(ProfileNode* node, std::uintptr_t ip) {
+    std::size_t h = head.load(relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= samples.size()) {
+      dropped.store(dropped.load(relaxed) + 1, relaxed);
+      return;
+    }
+    Sample& sample = samples[h % samples.size()];
+    sample.node = node;
+    sample.ip = ip;
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  std::vector<Sample> samples;
+  std::atomic<std::size_t> head, tail;
+  std::atomic<unsigned long> dropped;
+};
+
+struct ThreadTree {
+  ThreadTree() : root(0, NULL), current(&root), ring(NULL), inUse(true) {}
+
+  std::mutex mutex;
+  ProfileNode root;
+  // Atomic because it is read by the signal handler of the sampling
+  // profiler, on the same thread.
+  std::atomic<ProfileNode*> current;
+  std::atomic<SampleRing*> ring;
+  // Whether a thread owns the tree. Registry mutex must be locked.
+  bool inUse;
+};
+
+struct Registry {
+  Registry() : samplingCapacity(0), unattributedSamples(0) {}
+
+  std::mutex mutex;
+  std::vector<const char*> names;
+  // Trees are kept after their thread exited, for the reports, and reused
+  // by the next new thread, so that their number is the peak number of
+  // threads.
+  std::vector<std::unique_ptr<ThreadTree>> trees;
+
+  // Capacity of the sample rings, 0 if sampling is inactive.
+  std::size_t samplingCapacity;
+  // Rings are kept after sampling stopped, as the signal handler may still
+  // be running.
+  std::vector<std::unique_ptr<SampleRing>> rings;
+  // Samples drained from the rings: count per node and instruction pointer.
+  std::map<const ProfileNode*, std::map<std::uintptr_t, unsigned long>> ips;
+  // Samples of the threads without a tree.
+  std::atomic<unsigned long> unattributedSamples;
+};
+
+// Never destroyed, so that scopes can be used from static destructors.
+Registry& registry() {
+  static Registry* instance = new Registry;
+  return *instance;
+}
+
+// Initial exec TLS model, so that reading it from the signal handler does
+// not allocate.
+thread_local ThreadTree* currentTree
+    __attribute__((tls_model("initial-exec"))) = NULL;
+
+// Registry mutex must be locked.
+void addRing(Registry& r, ThreadTree& tree) {
+  if (r.samplingCapacity == 0 || tree.ring.load(relaxed) != NULL) return;
+  r.rings.emplace_back(new SampleRing(r.samplingCapacity));
+  tree.ring.store(r.rings.back().get(), std::memory_order_release);
+}
+
+// Releases the tree of the thread when it exits.
+struct TreeOwner {
+  ~TreeOwner() {
+    if (currentTree == NULL) return;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    currentTree->inUse = false;
+    currentTree = NULL;
+  }
+};
+
+// The registry mutex orders the writes of the thread which released a tree
+// before those of the thread reusing it.
+ThreadTree& threadTree() {
+  if (currentTree == NULL) {
+    thread_local TreeOwner owner;
+    (void)owner;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    ThreadTree* tree = NULL;
+    for (const auto& t : r.trees) {
+      if (!t->inUse) {
+        tree = t.get();
+        tree->inUse = true;
+        // The exited thread left all its scopes.
+        tree->current.store(&tree->root, relaxed);
+        break;
+      }
+    }
+    if (tree == NULL) {
+      tree = new ThreadTree;
+      r.trees.emplace_back(tree);
+    }
+    addRing(r, *tree);
+    currentTree = tree;
+  }
+  return *currentTree;
+}
+
+struct ReportNode {
+  ReportNode() : count(0), inclusive(0), samples(0) {}
+
+  unsigned long inclusiveSamples() const {
+    unsigned long n = samples;
+    for (const auto& child : children) n += child.second.inclusiveSamples();
+    return n;
+  }
+
+  double exclusive() const {
+    double e = inclusive;
+    for (const auto& child : children) e -= child.second.inclusive;
+    return std::max(e, 0.);
+  }
+
+  unsigned long count;
+  double inclusive;
+  /// Samples of the sampling profiler in this node, not in its children.
+  unsigned long samples;
+  std::map<std::uintptr_t, unsigned long> ips;
+  std::map<std::size_t, ReportNode> children;
+};
+
+// Registry mutex must be locked.
+void mergeIps(Registry& r, ReportNode& report, const ProfileNode& node) {
+  auto it = r.ips.find(&node);
+  if (it == r.ips.end()) return;
+  for (const auto& ip : it->second) report.ips[ip.first] += ip.second;
+}
+
+void merge(Registry& r, ReportNode& report, const ProfileNode& node) {
+  for (const ProfileNode* child : node.children) {
+    ReportNode& c = report.children[child->id];
+    c.count += child->count.load(relaxed);
+    c.inclusive += child->inclusive.load(relaxed);
+    c.samples += child->samples.load(relaxed);
+    mergeIps(r, c, *child);
+    merge(r, c, *child);
+  }
+}
+
+void reset(ProfileNode& node) {
+  node.count.store(0, relaxed);
+  node.inclusive.store(0, relaxed);
+  node.samples.store(0, relaxed);
+  for (ProfileNode* child : node.children) reset(*child);
+}
+
+// Move the samples of the rings to the registry. Registry mutex must be
+// locked.
+void drain(Registry& r) {
+  for (const auto& tree : r.trees) {
+    SampleRing* ring = tree->ring.load(std::memory_order_acquire);
+    if (ring == NULL) continue;
+    std::size_t head = ring->head.load(std::memory_order_acquire);
+    for (std::size_t i = ring->tail.load(relaxed); i != head; ++i) {
+      const SampleRing::Sample& s = ring->samples[i % ring->samples.size()];
+      ++r.ips[s.node][s.ip];
+    }
+    ring->tail.store(head, std::memory_order_release);
+  }
+}
+
+// Merge the trees of all the threads and copy the scope names.
+ReportNode collect(std::vector<const char*>& names) {
+  ReportNode report;
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  names = r.names;
+  drain(r);
+  for (const auto& tree : r.trees) {
+    std::lock_guard<std::mutex> treeLock(tree->mutex);
+    report.samples += tree->root.samples.load(relaxed);
+    mergeIps(r, report, tree->root);
+    merge(r, report, tree->root);
+  }
+  return report;
+}
+
+typedef std::vector<std::pair<std::size_t, const ReportNode*>> children_t;
+
+// Children of a node, by decreasing inclusive time.
+children_t sortedChildren(const ReportNode& node) {
+  children_t children;
+  for (const auto& child : node.children)
+    children.emplace_back(child.first, &child.second);
+  std::sort(
+      children.begin(), children.end(),
+      [](const children_t::value_type& a, const children_t::value_type& b) {
+        return a.second->inclusive > b.second->inclusive;
+      });
+  return children;
+}
+
+void printNode(std::ostream& os, const std::vector<const char*>& names,
+               std::size_t id, const ReportNode& node) {
+  os << iendl << names[id] << ": " << node.count << " calls, "
+     << node.inclusive << " s inclusive, " << node.exclusive()
+     << " s exclusive" << incindent;
+  for (const auto& child : sortedChildren(node))
+    printNode(os, names, child.first, *child.second);
+  os << decindent;
+}
+
+std::string symbol(std::uintptr_t ip) {
+  std::ostringstream oss;
+#if defined(HAVE_UNISTD_H) && defined(__linux__)
+  Dl_info info;
+  if (ip != 0 && dladdr((void*)ip, &info) != 0) {
+    if (info.dli_sname != NULL) {
+      int status;
+      char* demangled =
+          abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+      oss << (status == 0 ? demangled : info.dli_sname) << "+0x" << std::hex
+          << ip - (std::uintptr_t)info.dli_saddr;
+      std::free(demangled);
+      return oss.str();
+    }
+    if (info.dli_fname != NULL) {
+      oss << info.dli_fname << "+0x" << std::hex
+          << ip - (std::uintptr_t)info.dli_fbase;
+      return oss.str();
+    }
+  }
+#endif
+  oss << "0x" << std::hex << ip;
+  return oss.str();
+}
+
+void printSampledNode(std::ostream& os, const std::vector<const char*>& names,
+                      const char* name, const ReportNode& node, double total,
+                      std::size_t maxIps) {
+  unsigned long inclusive = node.inclusiveSamples();
+  if (inclusive == 0) return;
+  os << iendl << name << ": " << inclusive << " samples, "
+     << 100 * double(inclusive) / total << "% inclusive, "
+     << 100 * double(node.samples) / total << "% exclusive" << incindent;
+
+  std::vector<std::pair<unsigned long, std::uintptr_t>> ips;
+  for (const auto& ip : node.ips) ips.emplace_back(ip.second, ip.first);
+  std::sort(ips.rbegin(), ips.rend());
+  if (ips.size() > maxIps) ips.resize(maxIps);
+  for (const auto& ip : ips)
+    os << iendl << "at " << symbol(ip.second) << ": " << ip.first
+       << " samples";
+
+  std::vector<std::pair<unsigned long, std::size_t>> children;
+  for (const auto& child : node.children)
+    children.emplace_back(child.second.inclusiveSamples(), child.first);
+  std::sort(children.rbegin(), children.rend());
+  for (const auto& child : children)
+    printSampledNode(os, names, names[child.second],
+                     node.children.at(child.second), total, maxIps);
+  os << decindent;
+}
+
+void printCollapsedNode(std::ostream& os, const std::vector<const char*>& names,
+                        const std::string& path, const ReportNode& node) {
+  for (const auto& child : node.children) {
+    std::string p(path);
+    if (!p.empty()) p += ';';
+    p += names[child.first];
+    if (child.second.count > 0)
+      os << p << ' ' << std::llround(child.second.exclusive() * 1e9) << '\n';
+    printCollapsedNode(os, names, p, child.second);
+  }
+}
+}  // namespace
+
+ScopeId::ScopeId(const char* name) : name_(name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  index_ = r.names.size();
+  r.names.push_back(name);
+}
+
+const char* ScopeId::name(std::size_t index) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  return r.names[index];
+}
+
+void ProfileScope::enter(const ScopeId& id) {
+  ThreadTree& tree = threadTree();
+  ProfileNode* parent = tree.current.load(relaxed);
+  for (ProfileNode* child : parent->children)
+    if (child->id == id.index()) {
+      node_ = child;
+      break;
+    }
+  if (node_ == NULL) {
+    node_ = new ProfileNode(id.index(), parent);
+    std::lock_guard<std::mutex> lock(tree.mutex);
+    parent->children.push_back(node_);
+  }
+  tree.current.store(node_, relaxed);
+  start_ = clock_type::now();
+}
+
+void ProfileScope::leave() {
+  const double d =
+      std::chrono::duration<double>(clock_type::now() - start_).count();
+  node_->inclusive.store(node_->inclusive.load(relaxed) + d, relaxed);
+  node_->count.store(node_->count.load(relaxed) + 1, relaxed);
+  threadTree().current.store(node_->parent, relaxed);
+}
+
+std::ostream& printProfile(std::ostream& os) {
+  std::vector<const char*> names;
+  ReportNode report = collect(names);
+  os << "Profile:" << incindent;
+  for (const auto& child : sortedChildren(report))
+    printNode(os, names, child.first, *child.second);
+  return os << decindent;
+}
+
+std::ostream& printCollapsedProfile(std::ostream& os) {
+  std::vector<const char*> names;
+  ReportNode report = collect(names);
+  printCollapsedNode(os, names, "", report);
+  return os;
+}
+
+void resetProfile() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  drain(r);
+  r.ips.clear();
+  r.unattributedSamples.store(0, relaxed);
+  for (const auto& tree : r.trees) {
+    std::lock_guard<std::mutex> treeLock(tree->mutex);
+    reset(tree->root);
+  }
+}
+
+#if defined(HAVE_UNISTD_H) && defined(__linux__)
+namespace {
+std::uintptr_t instructionPointer(void* context) {
+  const ucontext_t* uc = (const ucontext_t*)context;
+#if defined(__x86_64__)
+  return (std::uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__i386__)
+  return (std::uintptr_t)uc->uc_mcontext.gregs[REG_EIP];
+#elif defined(__aarch64__)
+  return (std::uintptr_t)uc->uc_mcontext.pc;
+#else
+  (void)uc;
+  return 0;
+#endif
+}
+
+// Only uses async-signal-safe operations: atomic operations and reads of
+// an initial exec thread local variable.
+void onSample(int, siginfo_t*, void* context) {
+  int savedErrno = errno;
+  ThreadTree* tree = currentTree;
+  if (tree == NULL) {
+    registry().unattributedSamples.fetch_add(1, relaxed);
+  } else {
+    ProfileNode* node = tree->current.load(relaxed);
+    node->samples.store(node->samples.load(relaxed) + 1, relaxed);
+    if (SampleRing* ring = tree->ring.load(std::memory_order_acquire))
+      ring->push(node, instructionPointer(context));
+  }
+  errno = savedErrno;
+}
+
+void writeSamplingProfileToJournal() {
+  std::ostringstream oss;
+  printSamplingProfile(oss);
+  logging().benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                            oss.str());
+}
+}  // namespace
+
+bool startSampling(double frequency, std::size_t capacity) {
+  if (!(frequency > 0) || capacity == 0)
+    HPP_THROW(std::invalid_argument, "Invalid sampling frequency "
+                                         << frequency << " or capacity "
+                                         << capacity);
+  // Create the registry before the signal handler may use it.
+  Registry& r = registry();
+  {
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (r.samplingCapacity == 0) {
+      r.samplingCapacity = capacity;
+      for (const auto& tree : r.trees) addRing(r, *tree);
+    }
+  }
+
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_sigaction = onSample;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, NULL) != 0) return false;
+
+  double period = 1 / frequency;
+  struct itimerval timer;
+  timer.it_interval.tv_sec = (time_t)period;
+  timer.it_interval.tv_usec =
+      std::max((suseconds_t)((period - std::floor(period)) * 1e6),
+               (suseconds_t)(timer.it_interval.tv_sec == 0 ? 1 : 0));
+  timer.it_value = timer.it_interval;
+  return setitimer(ITIMER_PROF, &timer, NULL) == 0;
+}
+
+void stopSampling() {
+  struct itimerval timer;
+  std::memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_PROF, &timer, NULL);
+  // The handler stays installed, as a signal may still be pending.
+}
+
+void dumpSamplingProfileAtExit() {
+  static std::once_flag registered;
+  std::call_once(registered,
+                 []() { std::atexit(writeSamplingProfileToJournal); });
+}
+#else
+bool startSampling(double, std::size_t) { return false; }
+
+void stopSampling() {}
+
+void dumpSamplingProfileAtExit() {}
+#endif
+
+std::ostream& printSamplingProfile(std::ostream& os, std::size_t maxIps) {
+  std::vector<const char*> names;
+  ReportNode report = collect(names);
+  unsigned long dropped = 0, unattributed;
+  {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& ring : r.rings) dropped += ring->dropped.load(relaxed);
+    unattributed = r.unattributedSamples.load(relaxed);
+  }
+  unsigned long total = report.inclusiveSamples() + unattributed;
+  os << "Sampling profile: " << total << " samples";
+  if (dropped > 0)
+    os << ", " << dropped << " instruction pointers lost (full buffers)";
+  os << incindent;
+  if (total > 0) {
+    if (unattributed > 0)
+      os << iendl << "(threads without scopes): " << unattributed
+         << " samples, " << 100 * double(unattributed) / double(total) << '%';
+    printSampledNode(os, names, "(all scopes)", report, double(total),
+                     maxIps);
+  }
+  return os << decindent;
+}
+}  // namespace debug
+}  // namespace hpp
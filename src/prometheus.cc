@@ -0,0 +1,237 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/prometheus.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <hpp/util/debug.hh>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/util/timer.hh>
+#include <limits>
+#include <locale>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace hpp {
+namespace debug {
+namespace {
+struct Series {
+  unsigned long count;
+  double sum, max;
+  /// Whether all the counters of the series have a Histogram, without
+  /// which the buckets would miss values counted in +Inf.
+  bool allHaveBuckets;
+  /// Number of values below each bound.
+  std::vector<unsigned long> buckets;
+};
+
+// Label values escape the backslash, the double quote and the line feed.
+std::string escapeLabel(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\')
+      escaped += "\\\\";
+    else if (c == '"')
+      escaped += "\\\"";
+    else if (c == '\n')
+      escaped += "\\n";
+    else
+      escaped += c;
+  }
+  return escaped;
+}
+
+void addHistogram(Series& series, const Histogram& h,
+                  const std::vector<double>& bounds) {
+  std::size_t b = 0;
+  for (std::size_t i = 0; i < h.size(); ++i) {
+    const double upper = (double)h.upperBound(i) * 1e-9;
+    while (b < bounds.size() && upper > bounds[b]) ++b;
+    if (b == bounds.size()) break;
+    series.buckets[b] += h.bucket(i);
+  }
+}
+}  // namespace
+
+const std::vector<double>& defaultPrometheusBuckets() {
+  static const std::vector<double> buckets = {1e-6, 1e-5, 1e-4, 1e-3,
+                                              1e-2, 1e-1, 1,    10};
+  return buckets;
+}
+
+std::ostream& writeTimeCountersPrometheus(std::ostream& os,
+                                          const std::vector<double>& buckets,
+                                          bool threadSafeOnly) {
+  std::map<std::string, Series> series;
+  forEachTimeCounter(
+      [&series, &buckets](const TimeCounterBase& counter) {
+        TimeCounterBase::Snapshot s = counter.snapshot();
+        auto it = series.find(s.name);
+        if (it == series.end()) {
+          Series empty{0, 0, 0, true,
+                       std::vector<unsigned long>(buckets.size(), 0)};
+          it = series.emplace(s.name, empty).first;
+        }
+        Series& entry = it->second;
+        entry.count += s.count;
+        entry.sum += s.totalTime;
+        entry.max = std::max(entry.max, s.max);
+        if (std::unique_ptr<Histogram> h = counter.copyHistogram())
+          addHistogram(entry, *h, buckets);
+        else
+          entry.allHaveBuckets = false;
+      },
+      threadSafeOnly);
+
+  std::streamsize precision =
+      os.precision(std::numeric_limits<double>::digits10);
+  os << "# HELP hpp_time_counter_seconds Time measured by the time "
+        "counters.\n"
+        "# TYPE hpp_time_counter_seconds histogram\n";
+  for (const auto& entry : series) {
+    const std::string label = "name=\"" + escapeLabel(entry.first) + '"';
+    const Series& s = entry.second;
+    if (s.allHaveBuckets) {
+      unsigned long cumulated = 0;
+      for (std::size_t i = 0; i < buckets.size(); ++i) {
+        cumulated += s.buckets[i];
+        os << "hpp_time_counter_seconds_bucket{" << label << ",le=\""
+           << buckets[i] << "\"} " << cumulated << '\n';
+      }
+    }
+    os << "hpp_time_counter_seconds_bucket{" << label << ",le=\"+Inf\"} "
+       << s.count << '\n'
+       << "hpp_time_counter_seconds_sum{" << label << "} " << s.sum << '\n'
+       << "hpp_time_counter_seconds_count{" << label << "} " << s.count
+       << '\n';
+  }
+  os << "# HELP hpp_time_counter_max_seconds Longest measurement of the "
+        "time counters.\n"
+        "# TYPE hpp_time_counter_max_seconds gauge\n";
+  for (const auto& entry : series) {
+    os << "hpp_time_counter_max_seconds{name=\"" << escapeLabel(entry.first)
+       << "\"} " << entry.second.max << '\n';
+  }
+
+  // Counters of the same name are summed, the last gauge of a name is kept.
+  std::map<std::string, double> counters, gauges;
+  for (const MetricSnapshot& m : snapshotMetrics()) {
+    if (m.isCounter)
+      counters[m.name] += m.value;
+    else
+      gauges[m.name] = m.value;
+  }
+  os << "# HELP hpp_event_count_total Events counted by the event "
+        "counters.\n"
+        "# TYPE hpp_event_count_total counter\n";
+  for (const auto& entry : counters)
+    os << "hpp_event_count_total{name=\"" << escapeLabel(entry.first)
+       << "\"} " << entry.second << '\n';
+  os << "# HELP hpp_gauge Values of the gauges.\n"
+        "# TYPE hpp_gauge gauge\n";
+  for (const auto& entry : gauges)
+    os << "hpp_gauge{name=\"" << escapeLabel(entry.first) << "\"} "
+       << entry.second << '\n';
+  os.precision(precision);
+  return os;
+}
+
+bool writeTimeCountersPrometheus(const std::string& path,
+                                 const std::vector<double>& buckets,
+                                 bool threadSafeOnly) {
+  std::ostringstream oss;
+  oss.imbue(std::locale::classic());
+  writeTimeCountersPrometheus(oss, buckets, threadSafeOnly);
+
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp.c_str());
+    out << oss.str();
+    out.close();
+    if (!out) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+PrometheusExporter::PrometheusExporter(const std::string& path, double period,
+                                       const std::vector<double>& buckets)
+    : path_(path),
+      period_(period),
+      buckets_(buckets),
+      failed_(false),
+      stop_(false) {
+  if (!(period > 0))
+    HPP_THROW(std::invalid_argument,
+              "The period of the Prometheus exporter must be positive, got "
+                  << period);
+  thread_ = std::thread(&PrometheusExporter::run, this);
+}
+
+PrometheusExporter::~PrometheusExporter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wakeUp_.notify_one();
+  thread_.join();
+  write();
+}
+
+void PrometheusExporter::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    lock.unlock();
+    write();
+    lock.lock();
+    wakeUp_.wait_for(lock, std::chrono::duration<double>(period_),
+                     [this]() { return stop_; });
+  }
+}
+
+void PrometheusExporter::write() {
+  const bool ok = writeTimeCountersPrometheus(path_, buckets_, true);
+  if (!ok && !failed_)
+    hppLogf(error, "Failed to write the time counters to {}", path_);
+  failed_ = !ok;
+}
+}  // namespace debug
+}  // namespace hpp
@@ -0,0 +1,136 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/sharded.hh"
+
+#include <cstdint>
+
+namespace hpp {
+namespace debug {
+namespace internal {
+namespace {
+// Live Sharded objects, indexed by id, so that an exiting thread does not
+// release its shards to a destroyed object. Leaked, as threads may exit
+// after the static destructors ran.
+struct Registry {
+  std::mutex mutex;
+  std::vector<ShardedBase*> objects;
+  std::vector<std::size_t> freeIds;
+  // 0 is the generation of the empty slots.
+  std::uint64_t nextGeneration = 1;
+};
+
+Registry& registry() {
+  static Registry* instance = new Registry;
+  return *instance;
+}
+}  // namespace
+
+thread_local ShardedBase::ThreadShards ShardedBase::threadShards_;
+
+// Only the pointers are handed over: the shards themselves are neither read
+// nor written here, as the Sharded object may be destroying them.
+ShardedBase::ThreadShards::~ThreadShards() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (std::size_t id = 0; id < slots.size(); ++id) {
+    if (slots[id].shard == NULL || id >= r.objects.size()) continue;
+    ShardedBase* object = r.objects[id];
+    if (object == NULL || object->generation_ != slots[id].generation)
+      continue;
+    std::lock_guard<std::mutex> objectLock(object->mutex_);
+    object->freeShards_.push_back(slots[id].shard);
+  }
+  slots.clear();
+}
+
+ShardedBase::ShardedBase() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  if (r.freeIds.empty()) {
+    id_ = r.objects.size();
+    r.objects.push_back(this);
+  } else {
+    id_ = r.freeIds.back();
+    r.freeIds.pop_back();
+    r.objects[id_] = this;
+  }
+  generation_ = r.nextGeneration++;
+}
+
+ShardedBase::~ShardedBase() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.objects[id_] = NULL;
+  r.freeIds.push_back(id_);
+}
+
+void ShardedBase::setLocalShard(void* shard) {
+  std::vector<Slot>& slots = threadShards_.slots;
+  if (slots.size() <= id_) slots.resize(id_ + 1, Slot{NULL, 0});
+  slots[id_] = Slot{shard, generation_};
+}
+
+// The mutex orders the writes of the thread which released the shard before
+// those of the thread reusing it.
+void* ShardedBase::reuseShard() {
+  void* shard;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (freeShards_.empty()) return NULL;
+    shard = freeShards_.back();
+    freeShards_.pop_back();
+  }
+  setLocalShard(shard);
+  return shard;
+}
+
+void ShardedBase::addLocalShard(void* shard) {
+  setLocalShard(shard);
+  std::lock_guard<std::mutex> lock(mutex_);
+  shards_.push_back(shard);
+}
+
+// The address returned by operator new is stored just before the aligned
+// block.
+void* ShardedBase::allocate(std::size_t size) {
+  void* raw = ::operator new(size + cacheLineSize + sizeof(void*));
+  std::uintptr_t aligned =
+      (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + cacheLineSize -
+       1) &
+      ~(std::uintptr_t)(cacheLineSize - 1);
+  reinterpret_cast<void**>(aligned)[-1] = raw;
+  return reinterpret_cast<void*>(aligned);
+}
+
+void ShardedBase::deallocate(void* ptr) {
+  ::operator delete(static_cast<void**>(ptr)[-1]);
+}
+}  // namespace internal
+}  // namespace debug
+}  // namespace hpp
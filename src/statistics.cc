@@ -0,0 +1,180 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/statistics.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/util/serialization.hh>
+#include <stdexcept>
+#include <utility>
+
+namespace hpp {
+namespace debug {
+void RunningStatistics::merge(const RunningStatistics& other) {
+  if (other.n_ == 0) return;
+  if (n_ == 0) {
+    *this = other;
+    return;
+  }
+  // Chan et al. parallel update of the mean and of the sum of squares.
+  double n = double(n_ + other.n_);
+  double delta = other.mean_ - mean_;
+  mean_ += delta * double(other.n_) / n;
+  m2_ += other.m2_ + delta * delta * double(n_) * double(other.n_) / n;
+  n_ += other.n_;
+}
+
+double RunningStatistics::stddev() const { return std::sqrt(variance()); }
+
+template <class Archive>
+void RunningStatistics::serialize(Archive& ar, const unsigned int version) {
+  using hpp::serialization::make_nvp;
+  (void)version;
+  ar& make_nvp("count", n_);
+  ar& make_nvp("mean", mean_);
+  ar& make_nvp("m2", m2_);
+}
+
+HPP_SERIALIZATION_IMPLEMENT(RunningStatistics);
+
+ExponentialMovingAverage::ExponentialMovingAverage(double alpha)
+    : alpha_(alpha) {
+  if (!(alpha > 0 && alpha <= 1))
+    HPP_THROW(std::invalid_argument,
+              "Invalid moving average decay " << alpha
+                                              << ", should be in ]0, 1]");
+  reset();
+}
+
+RollingWindow::RollingWindow(std::size_t capacity, double duration)
+    : entries_(capacity), next_(0), size_(0), duration_(duration) {
+  if (capacity == 0 || !(duration >= 0))
+    HPP_THROW(std::invalid_argument, "Invalid rolling window capacity "
+                                         << capacity << " and duration "
+                                         << duration);
+}
+
+RollingWindow::Summary RollingWindow::summary(double now) const {
+  Summary s = {0, 0, 0, 0, 0};
+  RunningStatistics stats;
+  for (std::size_t i = 0; i < size_; ++i) {
+    const Entry& e = entries_[i];
+    if (duration_ > 0 && e.time < now - duration_) continue;
+    if (stats.count() == 0) {
+      s.min = s.max = e.value;
+    } else {
+      s.min = std::min(s.min, e.value);
+      s.max = std::max(s.max, e.value);
+    }
+    stats.record(e.value);
+  }
+  s.count = stats.count();
+  s.mean = stats.mean();
+  s.stddev = stats.stddev();
+  return s;
+}
+
+double median(std::vector<double> values) {
+  if (values.empty()) return 0;
+  std::size_t n = values.size();
+  std::vector<double>::iterator middle = values.begin() + n / 2;
+  std::nth_element(values.begin(), middle, values.end());
+  if (n % 2 == 1) return *middle;
+  // Mean of the two middle values: the lower one is the largest of the lower
+  // half.
+  double lower = *std::max_element(values.begin(), middle);
+  return (lower + *middle) / 2;
+}
+
+double medianAbsoluteDeviation(const std::vector<double>& values) {
+  double m = median(values);
+  std::vector<double> deviations(values.size());
+  for (std::size_t i = 0; i < values.size(); ++i)
+    deviations[i] = std::fabs(values[i] - m);
+  return median(deviations);
+}
+
+MannWhitneyTest mannWhitneyU(const std::vector<double>& a,
+                             const std::vector<double>& b) {
+  if (a.empty() || b.empty())
+    HPP_THROW(std::invalid_argument, "Mann-Whitney U test of an empty sample");
+  // Rank the union of the samples, ties getting their mean rank.
+  std::vector<std::pair<double, bool>> values;
+  values.reserve(a.size() + b.size());
+  for (double x : a) values.push_back(std::make_pair(x, true));
+  for (double x : b) values.push_back(std::make_pair(x, false));
+  std::sort(values.begin(), values.end());
+
+  const double n1 = (double)a.size(), n2 = (double)b.size(), n = n1 + n2;
+  double rankSumA = 0, ties = 0;
+  for (std::size_t i = 0; i < values.size();) {
+    std::size_t j = i;
+    while (j < values.size() && values[j].first == values[i].first) ++j;
+    double rank = double(i + j + 1) / 2, t = double(j - i);
+    for (std::size_t k = i; k < j; ++k)
+      if (values[k].second) rankSumA += rank;
+    ties += t * t * t - t;
+    i = j;
+  }
+
+  MannWhitneyTest test;
+  test.u = rankSumA - n1 * (n1 + 1) / 2;
+  double mean = n1 * n2 / 2;
+  double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+  if (variance <= 0) {
+    // All the values are equal.
+    test.z = 0;
+    test.pValue = 1;
+    return test;
+  }
+  double delta = test.u - mean;
+  double corrected = std::max(std::fabs(delta) - 0.5, 0.);
+  test.z = std::copysign(corrected, delta) / std::sqrt(variance);
+  test.pValue = std::min(std::erfc(std::fabs(test.z) / std::sqrt(2.)), 1.);
+  return test;
+}
+
+double normalQuantile(double p) {
+  if (!(p > 0 && p < 1))
+    HPP_THROW(std::invalid_argument,
+              "Invalid probability " << p << ", should be in ]0, 1[");
+  // Bisection on the cumulative distribution function, 0.5 erfc(-x/sqrt(2)).
+  double low = -40, high = 40;
+  for (int i = 0; i < 100; ++i) {
+    double x = (low + high) / 2;
+    if (0.5 * std::erfc(-x / std::sqrt(2.)) < p)
+      low = x;
+    else
+      high = x;
+  }
+  return (low + high) / 2;
+}
+}  // namespace debug
+}  // namespace hpp
@@ -27,31 +27,336 @@
 
 #include "hpp/util/timer.hh"
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/util/serialization.hh>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "config.h"
+
+// Dump on signal needs a pipe to wake up the dumping thread.
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+
+#include <csignal>
+#include <thread>
+#endif  // HAVE_UNISTD_H
+
+#include "hpp/util/debug.hh"
 
 using namespace std::chrono;
 
 namespace hpp {
 namespace debug {
-Timer::Timer(bool autoStart) : start_(), end_() {
+namespace {
+struct Registry {
+  std::mutex mutex;
+  std::vector<TimeCounterBase*> counters;
+  std::vector<EventCounter*> eventCounters;
+  std::vector<Gauge*> gauges;
+  /// Statistics of the destroyed counters, kept for the dump at exit.
+  std::vector<TimeCounterBase::Snapshot> retired;
+  std::vector<MetricSnapshot> retiredMetrics;
+  bool keepRetired = false;
+};
+
+void dumpAtExit() { dumpTimeCountersToJournal(); }
+
+void enableFromEnvVar() {
+  const char* env = std::getenv("HPP_DUMP_TIMECOUNTERS");
+  if (env == NULL) return;
+  if (std::strstr(env, "exit") != NULL) dumpTimeCountersAtExit();
+  if (std::strstr(env, "sigusr1") != NULL) dumpTimeCountersOnSignal();
+}
+
+// Leaked so that counters destroyed after it during exit can unregister.
+Registry& registry() {
+  static Registry* instance = new Registry;
+  return *instance;
+}
+
+template <typename T>
+void registerCounter(std::vector<T*> Registry::*counters, T* counter) {
+  static std::once_flag envVarRead;
+  std::call_once(envVarRead, enableFromEnvVar);
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  (r.*counters).push_back(counter);
+}
+
+// Keep the value of a destroyed metric if needed for the dump at exit.
+template <typename T>
+void unregisterMetric(std::vector<T*> Registry::*metrics, T* metric,
+                      bool isCounter) {
+  const MetricSnapshot s{metric->name(), isCounter, double(metric->value())};
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  std::vector<T*>& v = r.*metrics;
+  v.erase(std::remove(v.begin(), v.end(), metric), v.end());
+  if (r.keepRetired && s.value != 0) r.retiredMetrics.push_back(s);
+}
+}  // namespace
+
+TimeCounterBase::TimeCounterBase(const std::string& name)
+    : n_(name), traceName_(internTraceName(name)) {}
+
+TimeCounterBase::TimeCounterBase(const TimeCounterBase& other)
+    : n_(other.n_), traceName_(other.traceName_) {}
+
+TimeCounterBase& TimeCounterBase::operator=(const TimeCounterBase& other) {
+  n_ = other.n_;
+  traceName_ = other.traceName_;
+  return *this;
+}
+
+void TimeCounterBase::rename(const std::string& name) {
+  n_ = name;
+  traceName_ = internTraceName(name);
+}
+
+// Only a safety net for derived classes that do not call unregister: the
+// derived members are already destroyed here.
+TimeCounterBase::~TimeCounterBase() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.counters.erase(std::remove(r.counters.begin(), r.counters.end(), this),
+                   r.counters.end());
+}
+
+std::unique_ptr<Histogram> TimeCounterBase::copyHistogram() const {
+  return std::unique_ptr<Histogram>();
+}
+
+void TimeCounterBase::publish() { registerCounter(&Registry::counters, this); }
+
+void TimeCounterBase::unregister() {
+  Registry& r = registry();
+  {
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.counters.erase(std::remove(r.counters.begin(), r.counters.end(), this),
+                     r.counters.end());
+    if (!r.keepRetired) return;
+  }
+  // No other thread reaches the counter once it is unregistered.
+  Snapshot s = snapshot();
+  if (s.count == 0) return;
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.retired.push_back(s);
+}
+
+std::vector<TimeCounterBase::Snapshot> snapshotTimeCounters(
+    bool threadSafeOnly) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  std::vector<TimeCounterBase::Snapshot> snapshots;
+  snapshots.reserve(r.counters.size());
+  for (const TimeCounterBase* counter : r.counters)
+    if (!threadSafeOnly || counter->isThreadSafe())
+      snapshots.push_back(counter->snapshot());
+  return snapshots;
+}
+
+void forEachTimeCounter(const std::function<void(const TimeCounterBase&)>& f,
+                        bool threadSafeOnly) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (const TimeCounterBase* counter : r.counters)
+    if (!threadSafeOnly || counter->isThreadSafe()) f(*counter);
+}
+
+void resetTimeCounters() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (TimeCounterBase* counter : r.counters) counter->reset();
+  for (EventCounter* counter : r.eventCounters) counter->reset();
+  r.retired.clear();
+  r.retiredMetrics.clear();
+}
+
+std::vector<MetricSnapshot> snapshotMetrics() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  std::vector<MetricSnapshot> snapshots;
+  snapshots.reserve(r.eventCounters.size() + r.gauges.size());
+  for (const EventCounter* counter : r.eventCounters)
+    snapshots.push_back(
+        MetricSnapshot{counter->name(), true, double(counter->value())});
+  for (const Gauge* gauge : r.gauges)
+    snapshots.push_back(MetricSnapshot{gauge->name(), false, gauge->value()});
+  return snapshots;
+}
+
+std::ostream& dumpTimeCounters(std::ostream& os, bool threadSafeOnly) {
+  std::vector<TimeCounterBase::Snapshot> snapshots =
+      snapshotTimeCounters(threadSafeOnly);
+  {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    snapshots.insert(snapshots.end(), r.retired.begin(), r.retired.end());
+  }
+  std::stable_sort(snapshots.begin(), snapshots.end(),
+                   [](const TimeCounterBase::Snapshot& a,
+                      const TimeCounterBase::Snapshot& b) {
+                     return a.totalTime > b.totalTime;
+                   });
+  std::size_t width = 4;
+  for (const TimeCounterBase::Snapshot& s : snapshots)
+    width = std::max(width, s.name.size());
+
+  std::ios_base::fmtflags flags = os.flags();
+  os << std::left << std::setw(int(width)) << "name" << std::right
+     << std::setw(10) << "count" << std::setw(14) << "total" << std::setw(14)
+     << "min" << std::setw(14) << "mean" << std::setw(14) << "max"
+     << std::setw(14) << "p99" << std::setw(10) << "cpu/wall" << '\n';
+  for (const TimeCounterBase::Snapshot& s : snapshots) {
+    os << std::left << std::setw(int(width)) << s.name << std::right
+       << std::setw(10) << s.count << std::setw(14) << s.totalTime
+       << std::setw(14) << s.min << std::setw(14) << s.mean << std::setw(14)
+       << s.max << std::setw(14);
+    if (std::isnan(s.p99))
+      os << '-';
+    else
+      os << s.p99;
+    os << std::setw(10);
+    if (std::isnan(s.cpuRatio))
+      os << '-';
+    else
+      os << s.cpuRatio;
+    os << '\n';
+  }
+
+  std::vector<MetricSnapshot> metrics = snapshotMetrics();
+  {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    metrics.insert(metrics.end(), r.retiredMetrics.begin(),
+                   r.retiredMetrics.end());
+  }
+  if (!metrics.empty()) {
+    width = 4;
+    for (const MetricSnapshot& m : metrics)
+      width = std::max(width, m.name.size());
+    os << '\n'
+       << std::left << std::setw(int(width)) << "name" << std::right
+       << std::setw(10) << "kind" << std::setw(14) << "value" << '\n';
+    for (const MetricSnapshot& m : metrics)
+      os << std::left << std::setw(int(width)) << m.name << std::right
+         << std::setw(10) << (m.isCounter ? "counter" : "gauge")
+         << std::setw(14) << m.value << '\n';
+  }
+  os.flags(flags);
+  return os;
+}
+
+void dumpTimeCountersToJournal(bool threadSafeOnly) {
+  std::ostringstream oss;
+  dumpTimeCounters(oss << "Time counters:\n", threadSafeOnly);
+  logging().benchmark.write(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                            oss.str());
+}
+
+void dumpTimeCountersAtExit() {
+  static std::once_flag registered;
+  std::call_once(registered, []() {
+    {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.keepRetired = true;
+    }
+    std::atexit(dumpAtExit);
+  });
+}
+
+#if defined(HAVE_UNISTD_H) && defined(SIGUSR1)
+namespace {
+int signalPipe[2] = {-1, -1};
+
+void onSignal(int) {
+  char c = 0;
+  // Nothing can be done in a signal handler if the write fails.
+  ssize_t n = ::write(signalPipe[1], &c, 1);
+  (void)n;
+}
+
+void dumpOnSignal() {
+  char c;
+  // The measurements go on while this thread dumps.
+  while (::read(signalPipe[0], &c, 1) > 0) dumpTimeCountersToJournal(true);
+}
+}  // namespace
+
+void dumpTimeCountersOnSignal() {
+  static std::once_flag installed;
+  std::call_once(installed, []() {
+    if (::pipe(signalPipe) != 0) {
+      hppLogf(error, "Failed to create the pipe of the time counter dump: {}",
+              std::strerror(errno));
+      return;
+    }
+    std::thread(dumpOnSignal).detach();
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, NULL);
+  });
+}
+#else
+void dumpTimeCountersOnSignal() {}
+#endif
+
+Timer::Timer(bool autoStart)
+    : start_(),
+      end_(),
+      cpuEnabled_(false),
+      cpuStart_{0, 0, 0, 0},
+      cpu_{0, 0, 0, 0} {
   if (autoStart) start();
 }
 
-Timer::Timer(const Timer& timer) : start_(timer.start_), end_(timer.end_) {}
+Timer::Timer(const Timer& timer)
+    : start_(timer.start_),
+      end_(timer.end_),
+      cpuEnabled_(timer.cpuEnabled_),
+      cpuStart_(timer.cpuStart_),
+      cpu_(timer.cpu_) {}
 
 Timer& Timer::operator=(const Timer& timer) {
   if (this == &timer) return *this;
   start_ = timer.start_;
   end_ = timer.end_;
+  cpuEnabled_ = timer.cpuEnabled_;
+  cpuStart_ = timer.cpuStart_;
+  cpu_ = timer.cpu_;
   return *this;
 }
 
 Timer::~Timer() {}
 
-const Timer::time_point& Timer::start() { return start_ = clock_type::now(); }
+const Timer::time_point& Timer::start() {
+  if (cpuEnabled_) CpuUsage::read(cpuStart_);
+  return start_ = clock_type::now();
+}
 
-const Timer::time_point& Timer::stop() { return end_ = clock_type::now(); }
+const Timer::time_point& Timer::stop() {
+  end_ = clock_type::now();
+  if (cpuEnabled_) {
+    CpuUsage end;
+    if (CpuUsage::read(end)) cpu_ = end - cpuStart_;
+  }
+  return end_;
+}
 
 const Timer::time_point& Timer::getStart() const { return start_; }
 
@@ -64,28 +369,197 @@ std::ostream& Timer::print(std::ostream& o) const {
       system_clock::now() +
       duration_cast<system_clock::duration>(start_ - clock_type::now()));
 
-  return o << "timer started at "
-           << std::put_time(std::localtime(&time), "%F %T")
-           << " and elapsed time "
-              "is "
-           << duration();
+  o << "timer started at " << std::put_time(std::localtime(&time), "%F %T")
+    << " and elapsed time "
+       "is "
+    << duration();
+  if (cpuEnabled_) o << ", thread CPU time " << cpu_.threadTime;
+  return o;
+}
+
+namespace {
+std::atomic<double> overheadEstimate(0);
+std::once_flag overheadCalibrated;
+
+// Not inlined, so that the calibration includes the cost of a call like
+// TimeCounter::start and TimeCounter::stop.
+__attribute__((noinline)) DefaultClock::time_point readClock() {
+  return DefaultClock::now();
+}
+}  // namespace
+
+double calibrateTimeCounterOverhead(std::size_t iterations) {
+  if (iterations == 0) iterations = 1;
+  std::vector<double> samples(iterations);
+  for (double& sample : samples) {
+    DefaultClock::time_point start = readClock();
+    DefaultClock::time_point end = readClock();
+    sample = duration<double>(end - start).count();
+  }
+  std::nth_element(samples.begin(), samples.begin() + iterations / 2,
+                   samples.end());
+  double overhead = samples[iterations / 2];
+  overheadEstimate.store(overhead);
+  return overhead;
+}
+
+double timeCounterOverhead() {
+  std::call_once(overheadCalibrated, []() {
+    if (overheadEstimate.load() == 0) calibrateTimeCounterOverhead();
+  });
+  return overheadEstimate.load();
 }
 
 TimeCounter::TimeCounter(const std::string& name)
-    : n_(name),
+    : TimeCounterBase(name),
       c_(0),
       t_(duration_type::zero()),
       min_(duration_type::max()),
-      max_(duration_type::min()) {}
+      max_(duration_type::min()),
+      overhead_(duration_type::zero()),
+      running_(false),
+      perfEnabled_(false),
+      perfStarted_(false),
+      perfCount_(0),
+      allocEnabled_(false),
+      allocTracker_(NULL),
+      allocCount_(0),
+      allocStart_{0, 0, 0},
+      alloc_{0, 0, 0},
+      cpuEnabled_(false),
+      cpuStarted_(false),
+      cpuCount_(0),
+      cpuWall_(duration_type::zero()),
+      cpuStart_{0, 0, 0, 0},
+      cpu_{0, 0, 0, 0} {
+  perf_.mask = 0;
+  publish();
+}
+
+TimeCounter::TimeCounter(const TimeCounter& other)
+    : TimeCounterBase(other),
+      c_(other.c_),
+      t_(other.t_),
+      last_(other.last_),
+      min_(other.min_),
+      max_(other.max_),
+      overhead_(other.overhead_),
+      s_(other.s_),
+      running_(other.running_),
+      stats_(other.stats_),
+      ewma_(other.ewma_),
+      w_(other.w_ ? new RollingWindow(*other.w_) : NULL),
+      h_(other.h_ ? new Histogram(*other.h_) : NULL),
+      perfEnabled_(other.perfEnabled_),
+      perfStarted_(false),
+      perfCount_(other.perfCount_),
+      perf_(other.perf_),
+      allocEnabled_(other.allocEnabled_),
+      allocTracker_(NULL),
+      allocCount_(other.allocCount_),
+      allocStart_{0, 0, 0},
+      alloc_(other.alloc_),
+      cpuEnabled_(other.cpuEnabled_),
+      cpuStarted_(false),
+      cpuCount_(other.cpuCount_),
+      cpuWall_(other.cpuWall_),
+      cpuStart_{0, 0, 0, 0},
+      cpu_(other.cpu_) {
+  publish();
+}
+
+TimeCounter& TimeCounter::operator=(const TimeCounter& other) {
+  if (this == &other) return *this;
+  TimeCounterBase::operator=(other);
+  c_ = other.c_;
+  t_ = other.t_;
+  last_ = other.last_;
+  min_ = other.min_;
+  max_ = other.max_;
+  overhead_ = other.overhead_;
+  s_ = other.s_;
+  running_ = other.running_;
+  stats_ = other.stats_;
+  ewma_ = other.ewma_;
+  w_.reset(other.w_ ? new RollingWindow(*other.w_) : NULL);
+  h_.reset(other.h_ ? new Histogram(*other.h_) : NULL);
+  perfEnabled_ = other.perfEnabled_;
+  perfStarted_ = false;
+  perfCount_ = other.perfCount_;
+  perf_ = other.perf_;
+  if (allocTracker_ != NULL) allocTracker_->leave();
+  allocEnabled_ = other.allocEnabled_;
+  allocTracker_ = NULL;
+  allocCount_ = other.allocCount_;
+  alloc_ = other.alloc_;
+  cpuEnabled_ = other.cpuEnabled_;
+  cpuStarted_ = false;
+  cpuCount_ = other.cpuCount_;
+  cpuWall_ = other.cpuWall_;
+  cpu_ = other.cpu_;
+  return *this;
+}
 
-void TimeCounter::start() { s_ = clock_type::now(); }
+TimeCounter::~TimeCounter() {
+  unregister();
+  if (allocTracker_ != NULL) allocTracker_->leave();
+}
+
+void TimeCounter::start() {
+  if (allocEnabled_ && allocTracker_ == NULL) {
+    allocTracker_ = internal::allocationTracker.load(std::memory_order_acquire);
+    if (allocTracker_ != NULL) {
+      allocTracker_->enter();
+      allocStart_ = allocTracker_->read();
+    }
+  }
+  if (perfEnabled_) perfStarted_ = PerfCounters::read(perfStart_);
+  if (cpuEnabled_) cpuStarted_ = CpuUsage::read(cpuStart_);
+  s_ = clock_type::now();
+  running_ = true;
+}
 
 double TimeCounter::stop() {
-  last_ = clock_type::now() - s_;
+  time_point end = clock_type::now();
+  running_ = false;
+  last_ = std::max(duration_type(end - s_) - overhead_, duration_type::zero());
   min_ = std::min(last_, min_);
   max_ = std::max(last_, max_);
   t_ += last_;
   ++c_;
+  stats_.record(last_.count());
+  ewma_.record(last_.count());
+  if (w_)
+    w_->record(last_.count(), duration_type(end.time_since_epoch()).count());
+  if (h_) h_->record(last_.count());
+  if (perfStarted_) {
+    PerfCounters::Sample end;
+    if (PerfCounters::read(end)) {
+      if (perfCount_ == 0) {
+        perf_.mask = end.mask;
+        for (std::uint64_t& v : perf_.values) v = 0;
+      }
+      for (int e = 0; e < PerfCounters::NbEvents; ++e)
+        perf_.values[e] += end.values[e] - perfStart_.values[e];
+      ++perfCount_;
+    }
+    perfStarted_ = false;
+  }
+  if (allocTracker_ != NULL) {
+    alloc_ += allocTracker_->read() - allocStart_;
+    ++allocCount_;
+    allocTracker_->leave();
+    allocTracker_ = NULL;
+  }
+  if (cpuStarted_) {
+    CpuUsage end;
+    if (CpuUsage::read(end)) {
+      cpu_ += end - cpuStart_;
+      cpuWall_ += last_;
+      ++cpuCount_;
+    }
+    cpuStarted_ = false;
+  }
   return last_.count();
 }
 
@@ -96,6 +570,17 @@ void TimeCounter::reset() {
   c_ = 0;
   min_ = duration_type::max();
   max_ = duration_type::min();
+  stats_.reset();
+  ewma_.reset();
+  if (w_) w_->reset();
+  if (h_) h_->reset();
+  perfCount_ = 0;
+  perf_.mask = 0;
+  allocCount_ = 0;
+  alloc_ = AllocationCounts{0, 0, 0};
+  cpuCount_ = 0;
+  cpuWall_ = duration_type::zero();
+  cpu_ = CpuUsage{0, 0, 0, 0};
 }
 
 double TimeCounter::min() const { return min_.count(); }
@@ -108,13 +593,404 @@ double TimeCounter::mean() const {
 
 double TimeCounter::totalTime() const { return t_.count(); }
 
+void TimeCounter::subtractOverhead(bool enable) {
+  overhead_ = duration_type(enable ? timeCounterOverhead() : 0);
+}
+
+void TimeCounter::enableWindow(std::size_t capacity, double duration) {
+  w_.reset(new RollingWindow(capacity, duration));
+}
+
+RollingWindow::Summary TimeCounter::window() const {
+  if (!w_) return RollingWindow::Summary{0, 0, 0, 0, 0};
+  return w_->summary(
+      duration_type(clock_type::now().time_since_epoch()).count());
+}
+
+void TimeCounter::enableHistogram(unsigned precision, unsigned range) {
+  h_.reset(new Histogram(precision, range));
+}
+
+double TimeCounter::percentile(double p) const {
+  return h_ ? h_->percentile(p) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double TimeCounter::perfCounter(PerfCounters::Event e) const {
+  if (perfCount_ == 0 || !perf_.has(e))
+    return std::numeric_limits<double>::quiet_NaN();
+  return (double)perf_.values[e] / (double)perfCount_;
+}
+
+double TimeCounter::cpuRatio() const {
+  if (cpuCount_ == 0 || cpuWall_.count() <= 0)
+    return std::numeric_limits<double>::quiet_NaN();
+  return cpu_.threadTime / cpuWall_.count();
+}
+
+std::unique_ptr<Histogram> TimeCounter::copyHistogram() const {
+  std::unique_ptr<Histogram> h;
+  if (h_) h.reset(new Histogram(*h_));
+  return h;
+}
+
+TimeCounter::Snapshot TimeCounter::snapshot() const {
+  Snapshot s;
+  s.name = n_;
+  s.count = c_;
+  s.totalTime = totalTime();
+  s.min = (c_ > 0) ? min() : 0;
+  s.mean = mean();
+  s.max = (c_ > 0) ? max() : 0;
+  s.p99 = percentile(99);
+  s.cpuRatio = cpuRatio();
+  return s;
+}
+
 std::ostream& TimeCounter::print(std::ostream& os) const {
-  return os << "Time Counter " << n_ << ": " << c_ << ", " << totalTime()
-            << ", [ " << min() << ", " << mean() << ", " << max() << "]";
+  os << "Time Counter " << n_ << ": " << c_ << ", " << totalTime() << ", [ "
+     << min() << ", " << mean() << ", " << max() << "], stddev " << stddev()
+     << ", ewma " << ewma();
+  if (overhead_.count() > 0) os << ", overhead " << overhead_.count();
+  if (w_) {
+    RollingWindow::Summary w = window();
+    os << ", last " << w.count << ": [ " << w.min << ", " << w.mean << " +- "
+       << w.stddev << ", " << w.max << "]";
+  }
+  if (h_) h_->print(os << ", ");
+  if (perfCount_ > 0) {
+    if (perf_.has(PerfCounters::Cycles) &&
+        perf_.has(PerfCounters::Instructions) &&
+        perf_.values[PerfCounters::Cycles] > 0)
+      os << ", IPC "
+         << (double)perf_.values[PerfCounters::Instructions] /
+                (double)perf_.values[PerfCounters::Cycles];
+    for (PerfCounters::Event e :
+         {PerfCounters::CacheMisses, PerfCounters::BranchMisses})
+      if (perf_.has(e))
+        os << ", " << perfCounter(e) << ' ' << PerfCounters::name(e)
+           << "/call";
+  }
+  if (allocCount_ > 0)
+    os << ", " << double(alloc_.allocations) / double(allocCount_)
+       << " allocations/call, " << double(alloc_.bytes) / double(allocCount_)
+       << " bytes/call";
+  if (cpuCount_ > 0)
+    os << ", cpu/wall " << cpuRatio() << " (process "
+       << cpu_.processTime / cpuWall_.count() << "), "
+       << double(cpu_.voluntarySwitches) / double(cpuCount_)
+       << " voluntary and "
+       << double(cpu_.involuntarySwitches) / double(cpuCount_)
+       << " involuntary switches/call";
+  return os;
 }
 
 std::ostream& operator<<(std::ostream& os, const TimeCounter& tc) {
   return tc.print(os);
 }
+
+void TimeCounter::merge(const TimeCounter& other) {
+  // Keep the histogram only if it covers all the measurements, so that the
+  // percentiles do not describe a subset of them.
+  if (other.c_ > 0) {
+    if (!other.h_ || (!h_ && c_ > 0))
+      h_.reset();
+    else if (h_)
+      h_->merge(*other.h_);
+    else
+      h_.reset(new Histogram(*other.h_));
+  }
+  c_ += other.c_;
+  t_ += other.t_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  stats_.merge(other.stats_);
+  if (other.perfCount_ > 0) {
+    if (perfCount_ == 0)
+      perf_ = other.perf_;
+    else {
+      perf_.mask &= other.perf_.mask;
+      for (int e = 0; e < PerfCounters::NbEvents; ++e)
+        perf_.values[e] += other.perf_.values[e];
+    }
+    perfCount_ += other.perfCount_;
+  }
+  allocCount_ += other.allocCount_;
+  alloc_ += other.alloc_;
+  cpuCount_ += other.cpuCount_;
+  cpuWall_ += other.cpuWall_;
+  cpu_ += other.cpu_;
+}
+
+template <class Archive>
+void TimeCounter::save(Archive& ar, const unsigned int version) const {
+  using hpp::serialization::make_nvp;
+  (void)version;
+  double total = t_.count(), min = min_.count(), max = max_.count(),
+         cpuWall = cpuWall_.count();
+  ar& make_nvp("name", n_);
+  ar& make_nvp("count", c_);
+  ar& make_nvp("total", total);
+  ar& make_nvp("min", min);
+  ar& make_nvp("max", max);
+  ar& make_nvp("statistics", stats_);
+  bool hasHistogram = bool(h_);
+  ar& make_nvp("hasHistogram", hasHistogram);
+  if (hasHistogram) ar& make_nvp("histogram", *h_);
+  ar& make_nvp("perfCount", perfCount_);
+  if (perfCount_ > 0) {
+    ar& make_nvp("perfMask", perf_.mask);
+    for (const std::uint64_t& v : perf_.values) ar& make_nvp("perfValue", v);
+  }
+  ar& make_nvp("allocCount", allocCount_);
+  ar& make_nvp("allocations", alloc_.allocations);
+  ar& make_nvp("frees", alloc_.frees);
+  ar& make_nvp("bytes", alloc_.bytes);
+  ar& make_nvp("cpuCount", cpuCount_);
+  ar& make_nvp("cpuWall", cpuWall);
+  ar& make_nvp("threadTime", cpu_.threadTime);
+  ar& make_nvp("processTime", cpu_.processTime);
+  ar& make_nvp("voluntarySwitches", cpu_.voluntarySwitches);
+  ar& make_nvp("involuntarySwitches", cpu_.involuntarySwitches);
+}
+
+template <class Archive>
+void TimeCounter::load(Archive& ar, const unsigned int version) {
+  using hpp::serialization::make_nvp;
+  (void)version;
+  reset();
+  double total, min, max, cpuWall;
+  std::string name;
+  ar& make_nvp("name", name);
+  rename(name);
+  ar& make_nvp("count", c_);
+  ar& make_nvp("total", total);
+  ar& make_nvp("min", min);
+  ar& make_nvp("max", max);
+  t_ = duration_type(total);
+  min_ = duration_type(min);
+  max_ = duration_type(max);
+  ar& make_nvp("statistics", stats_);
+  bool hasHistogram;
+  ar& make_nvp("hasHistogram", hasHistogram);
+  if (hasHistogram) {
+    if (!h_) h_.reset(new Histogram);
+    ar& make_nvp("histogram", *h_);
+  } else
+    h_.reset();
+  ar& make_nvp("perfCount", perfCount_);
+  if (perfCount_ > 0) {
+    ar& make_nvp("perfMask", perf_.mask);
+    for (std::uint64_t& v : perf_.values) ar& make_nvp("perfValue", v);
+  }
+  ar& make_nvp("allocCount", allocCount_);
+  ar& make_nvp("allocations", alloc_.allocations);
+  ar& make_nvp("frees", alloc_.frees);
+  ar& make_nvp("bytes", alloc_.bytes);
+  ar& make_nvp("cpuCount", cpuCount_);
+  ar& make_nvp("cpuWall", cpuWall);
+  cpuWall_ = duration_type(cpuWall);
+  ar& make_nvp("threadTime", cpu_.threadTime);
+  ar& make_nvp("processTime", cpu_.processTime);
+  ar& make_nvp("voluntarySwitches", cpu_.voluntarySwitches);
+  ar& make_nvp("involuntarySwitches", cpu_.involuntarySwitches);
+}
+
+HPP_SERIALIZATION_SPLIT_IMPLEMENT(TimeCounter);
+
+bool saveTimeCounters(const std::string& filename) {
+  std::ofstream file(filename.c_str(), std::ios::binary);
+  if (!file) return false;
+  {
+    boost::archive::binary_oarchive ar(file);
+    // Each counter is preceded by a flag, false at the end of the list.
+    const bool more = true;
+    forEachTimeCounter([&ar, &more](const TimeCounterBase& counter) {
+      const TimeCounter* tc = dynamic_cast<const TimeCounter*>(&counter);
+      if (tc == NULL) return;
+      ar << more << *tc;
+    });
+    ar << false;
+  }
+  file.close();
+  return bool(file);
+}
+
+std::vector<std::unique_ptr<TimeCounter>> loadTimeCounters(
+    const std::string& filename) {
+  std::ifstream file(filename.c_str(), std::ios::binary);
+  if (!file)
+    HPP_THROW(std::runtime_error, "Failed to open " << filename);
+  std::vector<std::unique_ptr<TimeCounter>> counters;
+  try {
+    boost::archive::binary_iarchive ar(file);
+    bool more;
+    ar >> more;
+    while (more) {
+      counters.emplace_back(new TimeCounter(""));
+      ar >> *counters.back();
+      ar >> more;
+    }
+  } catch (const std::exception& e) {
+    // Archive errors, and invalid values such as a histogram bucket.
+    HPP_THROW(std::runtime_error,
+              "Failed to read time counters from " << filename << ": "
+                                                   << e.what());
+  }
+  return counters;
+}
+
+EventCounter::EventCounter(const std::string& name) : n_(name) {
+  registerCounter(&Registry::eventCounters, this);
+}
+
+EventCounter::~EventCounter() {
+  unregisterMetric(&Registry::eventCounters, this, true);
+}
+
+unsigned long EventCounter::value() const {
+  unsigned long n = 0;
+  shards_.forEach([&n](const Shard& s) {
+    n += s.value.load(std::memory_order_relaxed);
+  });
+  return n;
+}
+
+void EventCounter::reset() {
+  shards_.forEach(
+      [](Shard& s) { s.value.store(0, std::memory_order_relaxed); });
+}
+
+Gauge::Gauge(const std::string& name) : n_(name), value_(0) {
+  registerCounter(&Registry::gauges, this);
+}
+
+Gauge::~Gauge() { unregisterMetric(&Registry::gauges, this, false); }
+
+void Gauge::add(double delta) {
+  double v = value_.load(std::memory_order_relaxed);
+  while (!value_.compare_exchange_weak(v, v + delta,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+ConcurrentTimeCounter::Shard::Shard() : h(NULL) { reset(); }
+
+ConcurrentTimeCounter::Shard::~Shard() { delete h.load(); }
+
+void ConcurrentTimeCounter::Shard::reset() {
+  c = 0;
+  t = 0;
+  last = 0;
+  min = std::numeric_limits<double>::max();
+  max = std::numeric_limits<double>::lowest();
+  if (Histogram* histogram = h.load()) histogram->reset();
+}
+
+ConcurrentTimeCounter::ConcurrentTimeCounter(const std::string& name)
+    : TimeCounterBase(name),
+      histogramPrecision_(0),
+      histogramRange_(0),
+      overhead_(duration_type::zero()) {
+  publish();
+}
+
+ConcurrentTimeCounter::~ConcurrentTimeCounter() { unregister(); }
+
+Histogram* ConcurrentTimeCounter::createHistogram(Shard& shard) {
+  Histogram* h = new Histogram(histogramPrecision_, histogramRange_);
+  shard.h.store(h, std::memory_order_release);
+  return h;
+}
+
+void ConcurrentTimeCounter::enableHistogram(unsigned precision,
+                                            unsigned range) {
+  // Throw if the parameters are invalid.
+  Histogram check(precision, range);
+  (void)check;
+  histogramPrecision_ = precision;
+  histogramRange_ = range;
+}
+
+void ConcurrentTimeCounter::subtractOverhead(bool enable) {
+  overhead_ = duration_type(enable ? timeCounterOverhead() : 0);
+}
+
+std::unique_ptr<Histogram> ConcurrentTimeCounter::histogram() const {
+  std::unique_ptr<Histogram> merged;
+  if (histogramPrecision_ == 0) return merged;
+  merged.reset(new Histogram(histogramPrecision_, histogramRange_));
+  shards_.forEach([&merged](const Shard& s) {
+    if (const Histogram* h = s.h.load(std::memory_order_acquire))
+      merged->merge(*h);
+  });
+  return merged;
+}
+
+double ConcurrentTimeCounter::percentile(double p) const {
+  std::unique_ptr<Histogram> h = histogram();
+  return h ? h->percentile(p) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double ConcurrentTimeCounter::last() {
+  return shards_.local().last.load(std::memory_order_relaxed);
+}
+
+void ConcurrentTimeCounter::reset() {
+  shards_.forEach([](Shard& s) { s.reset(); });
+}
+
+ConcurrentTimeCounter::Totals ConcurrentTimeCounter::merge() const {
+  static constexpr std::memory_order relaxed = std::memory_order_relaxed;
+  Totals totals{0, 0, std::numeric_limits<double>::max(),
+                std::numeric_limits<double>::lowest()};
+  shards_.forEach([&totals](const Shard& s) {
+    totals.c += s.c.load(relaxed);
+    totals.t += s.t.load(relaxed);
+    totals.min = std::min(totals.min, s.min.load(relaxed));
+    totals.max = std::max(totals.max, s.max.load(relaxed));
+  });
+  return totals;
+}
+
+unsigned long ConcurrentTimeCounter::count() const { return merge().c; }
+
+double ConcurrentTimeCounter::min() const { return merge().min; }
+
+double ConcurrentTimeCounter::max() const { return merge().max; }
+
+double ConcurrentTimeCounter::mean() const {
+  Totals totals = merge();
+  return (totals.c > 0) ? totals.t / (double)totals.c : 0;
+}
+
+double ConcurrentTimeCounter::totalTime() const { return merge().t; }
+
+ConcurrentTimeCounter::Snapshot ConcurrentTimeCounter::snapshot() const {
+  Totals totals = merge();
+  Snapshot s;
+  s.name = n_;
+  s.count = totals.c;
+  s.totalTime = totals.t;
+  s.min = (totals.c > 0) ? totals.min : 0;
+  s.mean = (totals.c > 0) ? totals.t / (double)totals.c : 0;
+  s.max = (totals.c > 0) ? totals.max : 0;
+  s.p99 = percentile(99);
+  s.cpuRatio = std::numeric_limits<double>::quiet_NaN();
+  return s;
+}
+
+std::ostream& ConcurrentTimeCounter::print(std::ostream& os) const {
+  Totals totals = merge();
+  double mean = (totals.c > 0) ? totals.t / (double)totals.c : 0;
+  os << "Time Counter " << n_ << ": " << totals.c << ", " << totals.t << ", [ "
+     << totals.min << ", " << mean << ", " << totals.max << "]";
+  if (overhead_.count() > 0) os << ", overhead " << overhead_.count();
+  if (std::unique_ptr<Histogram> h = histogram()) h->print(os << ", ");
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const ConcurrentTimeCounter& tc) {
+  return tc.print(os);
+}
 }  // end of namespace debug
 }  // end of namespace hpp
@@ -0,0 +1,244 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "hpp/util/trace.hh"
+
+#include <cstdint>
+#include <hpp/util/clock.hh>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_set>
+#include <vector>
+
+// Include unistd.h if available, otherwise use the dummy getpid
+// function.
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#else
+static int getpid() { return 0; }
+#endif  // HAVE_UNISTD_H
+
+namespace hpp {
+namespace debug {
+namespace internal {
+std::atomic<bool> traceEnabled(false);
+}  // namespace internal
+
+namespace {
+constexpr std::memory_order relaxed = std::memory_order_relaxed;
+
+// 16 bytes per event: the lowest bit of the stamp tells whether the event is
+// an end event, the others hold the raw time stamp, see internal::rawStamp.
+struct Event {
+  const char* name;
+  std::uint64_t stamp;
+};
+
+// Chunks form a list, which the owning thread extends and other threads may
+// read concurrently. The events of a chunk are published by its size.
+struct Chunk {
+  static constexpr std::size_t capacity = 4096;
+
+  Chunk() : size(0), next(NULL) {}
+
+  Event events[capacity];
+  std::atomic<std::size_t> size;
+  std::atomic<Chunk*> next;
+};
+
+struct ThreadBuffer {
+  explicit ThreadBuffer(Chunk* head, std::size_t tid)
+      : tid(tid), head(head), tail(head), count(0), dropped(0) {}
+
+  const std::size_t tid;
+  Chunk* const head;
+  // Only used by the owning thread.
+  Chunk* tail;
+  std::size_t count;
+  std::atomic<unsigned long> dropped;
+};
+
+struct Registry {
+  Registry() : capacity(std::size_t(1) << 20) {}
+
+  std::mutex mutex;
+  std::atomic<std::size_t> capacity;
+  // Buffers are kept after their thread exited.
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  // Chunks released by clearTrace, reused before allocating new ones.
+  std::vector<Chunk*> freeChunks;
+  // Interned names, see internTraceName.
+  std::mutex namesMutex;
+  std::unordered_set<std::string> names;
+};
+
+// Never destroyed, so that events can be recorded from static destructors.
+Registry& registry() {
+  static Registry* instance = new Registry;
+  return *instance;
+}
+
+Chunk* takeChunk(Registry& r) {
+  if (r.freeChunks.empty()) return new Chunk;
+  Chunk* chunk = r.freeChunks.back();
+  r.freeChunks.pop_back();
+  chunk->size.store(0, relaxed);
+  chunk->next.store(NULL, relaxed);
+  return chunk;
+}
+
+thread_local ThreadBuffer* currentBuffer
+    __attribute__((tls_model("initial-exec"))) = NULL;
+
+ThreadBuffer& threadBuffer() {
+  if (currentBuffer == NULL) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    currentBuffer = new ThreadBuffer(takeChunk(r), r.buffers.size() + 1);
+    r.buffers.emplace_back(currentBuffer);
+  }
+  return *currentBuffer;
+}
+
+// Called once every Chunk::capacity events, out of the recording path.
+__attribute__((noinline)) Chunk* extend(ThreadBuffer& b) {
+  Registry& r = registry();
+  if (b.count >= r.capacity.load(relaxed)) return NULL;
+  Chunk* next;
+  {
+    std::lock_guard<std::mutex> lock(r.mutex);
+    next = takeChunk(r);
+  }
+  b.tail->next.store(next, std::memory_order_release);
+  return b.tail = next;
+}
+
+void writeString(std::ostream& os, const char* str) {
+  os << '"';
+  for (; *str != '\0'; ++str) {
+    if (*str == '"' || *str == '\\')
+      os << '\\' << *str;
+    else if ((unsigned char)*str < 0x20)
+      os << ' ';
+    else
+      os << *str;
+  }
+  os << '"';
+}
+}  // namespace
+
+namespace internal {
+void traceEvent(const char* name, char phase) {
+  const std::uint64_t stamp = rawStamp();
+  ThreadBuffer& b = threadBuffer();
+  Chunk* chunk = b.tail;
+  std::size_t n = chunk->size.load(relaxed);
+  if (n == Chunk::capacity) {
+    chunk = extend(b);
+    if (chunk == NULL) {
+      b.dropped.store(b.dropped.load(relaxed) + 1, relaxed);
+      return;
+    }
+    n = 0;
+  }
+  chunk->events[n] = Event{name, (stamp << 1) | (phase == 'E')};
+  chunk->size.store(n + 1, std::memory_order_release);
+  ++b.count;
+}
+}  // namespace internal
+
+void enableTrace(bool enable) {
+  // Calibrate the time stamp counter now rather than in the first event.
+  if (enable) internal::rawStampToNanoseconds(internal::rawStamp());
+  internal::traceEnabled.store(enable);
+}
+
+void setTraceCapacity(std::size_t eventsPerThread) {
+  registry().capacity.store(eventsPerThread);
+}
+
+const char* internTraceName(const std::string& name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.namesMutex);
+  // Elements of an unordered set are not moved by the insertions.
+  return r.names.insert(name).first->c_str();
+}
+
+std::ostream& writeTrace(std::ostream& os) {
+  const int pid = (int)getpid();
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  const char* separator = "\n";
+  std::ios::fmtflags flags = os.flags();
+  os << std::fixed << std::setprecision(3);
+  for (const auto& buffer : r.buffers) {
+    for (const Chunk* chunk = buffer->head; chunk != NULL;
+         chunk = chunk->next.load(std::memory_order_acquire)) {
+      const std::size_t size = chunk->size.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < size; ++i) {
+        const Event& e = chunk->events[i];
+        os << separator << "{\"name\":";
+        writeString(os, e.name);
+        os << ",\"ph\":\"" << ((e.stamp & 1) ? 'E' : 'B')
+           << "\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+           << ",\"ts\":"
+           << (double)internal::rawStampToNanoseconds(e.stamp >> 1) * 1e-3
+           << '}';
+        separator = ",\n";
+      }
+    }
+    if (unsigned long dropped = buffer->dropped.load(relaxed)) {
+      os << separator << "{\"name\":\"dropped events\",\"ph\":\"C\",\"pid\":"
+         << pid << ",\"tid\":" << buffer->tid
+         << ",\"ts\":0,\"args\":{\"count\":" << dropped << "}}";
+      separator = ",\n";
+    }
+  }
+  os.flags(flags);
+  return os << "\n]}\n";
+}
+
+void clearTrace() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (const auto& buffer : r.buffers) {
+    // Iterate rather than recurse, since the list may be long.
+    for (Chunk* chunk = buffer->head->next.exchange(NULL); chunk != NULL;
+         chunk = chunk->next.load(relaxed))
+      r.freeChunks.push_back(chunk);
+    buffer->head->size.store(0);
+    buffer->tail = buffer->head;
+    buffer->count = 0;
+    buffer->dropped.store(0);
+  }
+}
+}  // namespace debug
+}  // namespace hpp
@@ -0,0 +1,87 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <hpp/util/allocation.hh>
+#include <hpp/util/timer.hh>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+// Prevent the compiler from removing the pairs of new and delete.
+void* volatile sink;
+
+int test_scope() {
+  if (!isAllocationTrackingAvailable()) return TEST_FAILED;
+  AllocScope outer;
+  {
+    AllocScope inner;
+    int* p = new int(1);
+    sink = p;
+    delete p;
+    std::vector<char> v(100);
+    sink = v.data();
+    AllocationCounts c = inner.counts();
+    if (c.allocations != 2 || c.frees != 1 || c.bytes != sizeof(int) + 100)
+      return TEST_FAILED;
+  }
+  if (outer.counts().allocations != 2 || outer.counts().frees != 2)
+    return TEST_FAILED;
+
+  // Allocations outside of the scopes are not counted.
+  AllocationCounts before = outer.counts();
+  std::unique_ptr<int> p(new int(2));
+  sink = p.get();
+  if (outer.counts().allocations != before.allocations + 1) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_time_counter() {
+  TimeCounter counter("allocations");
+  counter.enableAllocationTracking();
+  for (int i = 0; i < 10; ++i) {
+    TimeCounter::Scope scope(counter);
+    std::vector<double> v(8);
+    sink = v.data();
+  }
+  std::cout << counter << std::endl;
+  if (counter.allocations().allocations != 10 ||
+      counter.allocations().bytes != 10 * 8 * sizeof(double))
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_scope() != TEST_SUCCEED) return TEST_FAILED;
+  return test_time_counter();
+}
+
+GENERATE_TEST()
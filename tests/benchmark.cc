@@ -0,0 +1,222 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <fstream>
+#include <hpp/util/benchmark.hh>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+HPP_BENCHMARK(sum) {
+  std::vector<double> values(100, 1.);
+  while (state.keepRunning())
+    doNotOptimize(std::accumulate(values.begin(), values.end(), 0.));
+}
+
+HPP_BENCHMARK(paused) {
+  while (state.keepRunning()) {
+    state.pauseTiming();
+    std::vector<double> values(1000, 1.);
+    doNotOptimize(values.data());
+    state.resumeTiming();
+  }
+}
+
+int test_state() {
+  BenchmarkState state(3);
+  int n = 0;
+  while (state.keepRunning()) ++n;
+  if (n != 3) return TEST_FAILED;
+  BenchmarkState empty(0);
+  if (empty.keepRunning()) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_run() {
+  BenchmarkOptions options;
+  options.minTime = 0.001;
+  options.repetitions = 5;
+  options.warmupTime = 0;
+  std::vector<BenchmarkResult> results = runBenchmarks(options);
+  if (results.size() != 2) return TEST_FAILED;
+  const BenchmarkResult& sum = results[0];
+  if (sum.name != "sum" || sum.samples.size() != 5) return TEST_FAILED;
+  // The number of iterations is chosen to reach the minimal time.
+  if (sum.iterations < 2) return TEST_FAILED;
+  if (!(sum.min > 0 && sum.min <= sum.median && sum.median <= sum.max))
+    return TEST_FAILED;
+  if (sum.median * double(sum.iterations) < options.minTime * 0.5)
+    return TEST_FAILED;
+  printBenchmarks(std::cout, results);
+
+  std::ostringstream json;
+  writeBenchmarksJson(json, results);
+  if (json.str().find("\"name\": \"paused\"") == std::string::npos)
+    return TEST_FAILED;
+  if (json.str().find("\"samples\": [") == std::string::npos)
+    return TEST_FAILED;
+
+  std::ostringstream csv;
+  writeBenchmarksCsv(csv, results);
+  if (csv.str().compare(0, 6, "name,i") != 0) return TEST_FAILED;
+  if (csv.str().find("\nsum,") == std::string::npos) return TEST_FAILED;
+  std::vector<BenchmarkResult> quoted(1, results[0]);
+  quoted[0].name = "sum<int, \"a\">";
+  csv.str("");
+  writeBenchmarksCsv(csv, quoted);
+  if (csv.str().find("\n\"sum<int, \"\"a\"\">\",") == std::string::npos)
+    return TEST_FAILED;
+
+  options.filter = "pause";
+  if (runBenchmarks(options).size() != 1) return TEST_FAILED;
+  options.repetitions = 0;
+  CHECK_FAILURE(std::invalid_argument, runBenchmarks(options));
+  return TEST_SUCCEED;
+}
+
+BenchmarkResult makeResult(const std::string& name, double scale) {
+  BenchmarkResult r;
+  r.name = name;
+  r.iterations = 10;
+  for (int i = 0; i < 20; ++i) r.samples.push_back(scale * (1 + 0.01 * i));
+  r.median = r.mad = r.mean = r.min = r.max = scale;
+  return r;
+}
+
+int test_compare() {
+  std::vector<BenchmarkResult> baseline = {makeResult("same", 1e-6),
+                                           makeResult("slower", 1e-6),
+                                           makeResult("removed", 1e-6)},
+                               contender = {makeResult("slower", 1.2e-6),
+                                            makeResult("same", 1e-6)};
+
+  // Round trip through JSON.
+  std::stringstream json;
+  writeBenchmarksJson(json, baseline);
+  std::vector<BenchmarkResult> read = readBenchmarksJson(json);
+  if (read.size() != 3 || read[1].name != "slower") return TEST_FAILED;
+  if (read[1].samples != baseline[1].samples) return TEST_FAILED;
+  std::istringstream invalid("{\"benchmarks\": [ {\"name\": 1} ]}");
+  CHECK_FAILURE(std::runtime_error, readBenchmarksJson(invalid));
+
+  std::vector<BenchmarkComparison> comparisons =
+      compareBenchmarks(read, contender);
+  if (comparisons.size() != 2) return TEST_FAILED;
+  const BenchmarkComparison &same = comparisons[0], &slower = comparisons[1];
+  if (same.name != "same" || slower.name != "slower") return TEST_FAILED;
+  if (same.isRegression(0.05, 0.05) || same.pValue < 0.5) return TEST_FAILED;
+  if (!(same.changeLow <= 0 && same.changeHigh >= 0)) return TEST_FAILED;
+  if (!slower.isRegression(0.05, 0.05)) return TEST_FAILED;
+  if (slower.isRegression(0.05, 0.5)) return TEST_FAILED;
+  if (std::fabs(slower.change - 0.2) > 0.05) return TEST_FAILED;
+  if (!(slower.changeLow < slower.change && slower.change < slower.changeHigh))
+    return TEST_FAILED;
+
+  // The null baseline samples are ignored, also in the confidence interval.
+  BenchmarkResult withZeros = makeResult("zeros", 1e-6), positive(withZeros);
+  positive.samples.resize(10);
+  withZeros.samples = positive.samples;
+  withZeros.samples.resize(20, 0);
+  comparisons = compareBenchmarks({withZeros}, {positive});
+  if (comparisons.size() != 1) return TEST_FAILED;
+  if (!(comparisons[0].changeLow < 0 && comparisons[0].changeHigh > 0))
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+void writeFile(const boost::filesystem::path& path, const char* content) {
+  boost::filesystem::create_directories(path.parent_path());
+  std::ofstream(path.string().c_str()) << content;
+}
+
+int test_environment() {
+  std::vector<int> cpus = parseCpuList("0-2,5,7-8\n");
+  if (cpus != std::vector<int>({0, 1, 2, 5, 7, 8})) return TEST_FAILED;
+  if (!parseCpuList("").empty()) return TEST_FAILED;
+  CHECK_FAILURE(std::invalid_argument, parseCpuList("0-"));
+  CHECK_FAILURE(std::invalid_argument, parseCpuList("3-1"));
+
+  namespace fs = boost::filesystem;
+  fs::path root = fs::temp_directory_path() / fs::unique_path();
+  fs::path cpu = root / "sys/devices/system/cpu";
+  writeFile(cpu / "online", "0-3\n");
+  writeFile(cpu / "isolated", "2-3\n");
+  writeFile(cpu / "cpu0/cpufreq/scaling_governor", "performance\n");
+  writeFile(cpu / "cpu1/cpufreq/scaling_governor", "performance\n");
+  writeFile(cpu / "cpu2/cpufreq/scaling_governor", "powersave\n");
+  writeFile(cpu / "cpu3/cpufreq/scaling_governor", "powersave\n");
+  writeFile(cpu / "intel_pstate/no_turbo", "0\n");
+  writeFile(root / "proc/loadavg", "1.50 0.75 0.25 2/300 1234\n");
+
+  BenchmarkEnvironment env = BenchmarkEnvironment::read(root.string());
+  if (env.cpus.size() != 4 || env.governors.size() != 4) return TEST_FAILED;
+  if (env.governors[2] != "powersave") return TEST_FAILED;
+  if (env.turbo != 1 || env.load[0] != 1.5 || env.load[2] != 0.25)
+    return TEST_FAILED;
+  if (env.isolated != std::vector<int>({2, 3})) return TEST_FAILED;
+  // Governor, turbo, load of 1.5 over 4 processors and processor 1 not
+  // isolated.
+  if (env.problems(0.25, 1).size() != 4) return TEST_FAILED;
+  if (env.problems(0.5, 2).size() != 2) return TEST_FAILED;
+  std::ostringstream os;
+  os << env;
+  std::cout << os.str();
+  if (os.str().find("powersave (2-3)") == std::string::npos)
+    return TEST_FAILED;
+
+  writeFile(cpu / "cpu2/cpufreq/scaling_governor", "performance\n");
+  writeFile(cpu / "cpu3/cpufreq/scaling_governor", "performance\n");
+  writeFile(cpu / "intel_pstate/no_turbo", "1\n");
+  env = BenchmarkEnvironment::read(root.string());
+  if (env.turbo != 0 || !env.problems(2, 3).empty()) return TEST_FAILED;
+  fs::remove_all(root);
+
+  // Everything is unknown without the file systems.
+  env = BenchmarkEnvironment::read(root.string());
+  if (!env.cpus.empty() || env.turbo != -1 || env.load[0] >= 0)
+    return TEST_FAILED;
+  if (!env.problems(0, 0).empty()) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_state() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_environment() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_compare() != TEST_SUCCEED) return TEST_FAILED;
+  return test_run();
+}
+
+GENERATE_TEST()
@@ -0,0 +1,98 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <hpp/util/budget.hh>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+int test_overrun() {
+  BudgetCounter counter("overrun", 2e-3);
+  unsigned long calls = 0;
+  double overrun = 0;
+  counter.onOverrun([&calls, &overrun](const BudgetCounter& c, double d) {
+    ++calls;
+    overrun = d - c.budget();
+  });
+  counter.enableOverrunLog();
+  {
+    BudgetScope scope(counter);
+    if (scope.expired()) return TEST_FAILED;
+  }
+  for (int i = 0; i < 2; ++i) {
+    BudgetScope scope(counter);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    // The clock is read at the first call.
+    if (!scope.expired()) return TEST_FAILED;
+    if (!(scope.remaining() < 0)) return TEST_FAILED;
+  }
+  std::cout << counter << std::endl;
+  if (counter.count() != 3 || counter.overruns() != 2) return TEST_FAILED;
+  if (calls != 2 || !(overrun >= 3e-3)) return TEST_FAILED;
+  if (!(counter.maxOverrun() >= overrun)) return TEST_FAILED;
+  if (!(counter.totalOverrun() >= 6e-3)) return TEST_FAILED;
+
+  counter.reset();
+  if (counter.count() != 0 || counter.overruns() != 0) return TEST_FAILED;
+  CHECK_FAILURE(std::invalid_argument, counter.setBudget(0));
+  CHECK_FAILURE(std::invalid_argument, BudgetCounter("negative", -1));
+  return TEST_SUCCEED;
+}
+
+int test_expired() {
+  unsigned long iterations = 0;
+  double elapsed;
+  {
+    HPP_BUDGET_SCOPE(loop, 5e-3);
+    while (!loop.expired()) ++iterations;
+    elapsed = loop.elapsed();
+  }
+  std::cout << "expired: " << 1e9 * elapsed / double(iterations)
+            << " ns per call, stopped after " << elapsed << " s" << std::endl;
+  if (!(elapsed >= 5e-3)) return TEST_FAILED;
+  // The clock is read about every 5 microseconds.
+  if (!(elapsed < 15e-3)) return TEST_FAILED;
+
+  bool found = false;
+  for (const TimeCounterBase::Snapshot& s : snapshotTimeCounters())
+    if (s.name == "loop") found = (s.count == 1 && s.min >= 5e-3);
+  if (!found) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_overrun() != TEST_SUCCEED) return TEST_FAILED;
+  return test_expired();
+}
+
+GENERATE_TEST()
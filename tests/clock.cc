@@ -0,0 +1,79 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <chrono>
+#include <hpp/util/clock.hh>
+#include <iostream>
+#include <thread>
+
+#include "common.hh"
+#include "config.h"
+
+using hpp::debug::TscClock;
+
+int test_monotonic() {
+  TscClock::time_point last = TscClock::now();
+  for (int i = 0; i < 100000; ++i) {
+    TscClock::time_point t = TscClock::now();
+    if (t < last) return TEST_FAILED;
+    last = t;
+  }
+  return TEST_SUCCEED;
+}
+
+int test_calibration() {
+  std::cout << "time stamp counter used: " << TscClock::isTscUsed()
+            << ", frequency: " << TscClock::tscFrequency() << " Hz"
+            << std::endl;
+  // Both clocks share the same origin.
+  auto steady = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch());
+  auto tsc = TscClock::now().time_since_epoch();
+  if (tsc - steady > std::chrono::milliseconds(1) ||
+      steady - tsc > std::chrono::milliseconds(1))
+    return TEST_FAILED;
+
+  // Both clocks measure the same durations, within 2%.
+  std::chrono::steady_clock::time_point s0 = std::chrono::steady_clock::now();
+  TscClock::time_point t0 = TscClock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  TscClock::time_point t1 = TscClock::now();
+  std::chrono::steady_clock::time_point s1 = std::chrono::steady_clock::now();
+  double ds = std::chrono::duration<double>(s1 - s0).count();
+  double dt = std::chrono::duration<double>(t1 - t0).count();
+  std::cout << "steady_clock: " << ds << " s, TscClock: " << dt << " s"
+            << std::endl;
+  if (dt > ds || dt < 0.98 * ds) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_monotonic() != TEST_SUCCEED) return TEST_FAILED;
+  return test_calibration();
+}
+
+GENERATE_TEST()
@@ -34,7 +34,52 @@
 
 using namespace hpp::debug;
 
+// Output that keeps the last record in memory.
+class StringOutput : public Output {
+ public:
+  void write(const Channel& channel, char const* file, int line,
+             char const* function, const std::string& data) {
+    std::stringstream ss;
+    writePrefix(ss, channel, file, line, function) << data;
+    last = ss.str();
+  }
+
+  void write(const Channel& channel, char const* file, int line,
+             char const* function, const std::stringstream& data) {
+    write(channel, file, line, function, data.str());
+  }
+
+  std::string last;
+};
+
+int test_context() {
+  StringOutput out;
+  Channel channel("TEST", {&out});
+  channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, std::string("a\n"));
+  if (out.last.find("]TEST:") == std::string::npos) return TEST_FAILED;
+  {
+    LogContext context("planner-3");
+    context.tag("request", 42);
+    {
+      LogContext inner;
+      inner.tag("step", "projection");
+      channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                    std::string("b\n"));
+      if (out.last.find("[planner-3 request=42 step=projection]TEST:") ==
+          std::string::npos)
+        return TEST_FAILED;
+    }
+    if (LogContext::current() != &context) return TEST_FAILED;
+  }
+  if (LogContext::current() != NULL) return TEST_FAILED;
+  channel.write(__FILE__, __LINE__, __PRETTY_FUNCTION__, std::string("c\n"));
+  if (out.last.find("]TEST:") == std::string::npos) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
 int run_test() {
+  if (test_context() != TEST_SUCCEED) return TEST_FAILED;
+
   ConsoleOutput console;
   JournalOutput out("debug.test.log");
   Channel channel("TEST", {&out, &console});
@@ -0,0 +1,135 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <hpp/util/flight-recorder.hh>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+std::size_t occurrences(const std::string& str, const std::string& pattern) {
+  std::size_t n = 0;
+  for (std::size_t pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1))
+    ++n;
+  return n;
+}
+
+std::string flightRecord() {
+  std::stringstream ss;
+  writeFlightRecord(ss);
+  return ss.str();
+}
+
+void work() {
+  for (int i = 0; i < 100; ++i) {
+    hppTraceScope(step);
+    hppTrace(point, 42);
+  }
+}
+
+void wrap() {
+  for (int i = 0; i < 100; ++i) hppTrace(wrapped, i);
+}
+
+int test_recording() {
+  std::thread t1(work), t2(work);
+  t1.join();
+  t2.join();
+  const std::string record = flightRecord();
+  if (occurrences(record, "\"name\":\"step\",\"ph\":\"B\"") != 200)
+    return TEST_FAILED;
+  if (occurrences(record, "\"name\":\"step\",\"ph\":\"E\"") != 200)
+    return TEST_FAILED;
+  if (occurrences(record, "\"name\":\"point\",\"ph\":\"i\"") != 200)
+    return TEST_FAILED;
+  if (occurrences(record, "\"args\":{\"payload\":42}") != 200)
+    return TEST_FAILED;
+
+  // The ring of a thread keeps the most recent events.
+  setFlightRecorderCapacity(10);
+  std::thread t3(wrap);
+  t3.join();
+  setFlightRecorderCapacity(4096);
+  const std::string wrapped = flightRecord();
+  if (occurrences(wrapped, "\"name\":\"wrapped\"") != 16) return TEST_FAILED;
+  if (occurrences(wrapped, "\"payload\":84}") != 1) return TEST_FAILED;
+  if (occurrences(wrapped, "\"payload\":83}") != 0) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_trigger() {
+  static const ScopeId id("slow");
+  setFlightRecordPrefix("flight-recorder-test");
+  std::remove("flight-recorder-test.0.json");
+  dumpFlightRecordWhenLonger(id, 1e-3);
+  { FlightScope fast(id); }
+  if (std::ifstream("flight-recorder-test.0.json")) return TEST_FAILED;
+  for (int i = 0; i < 2; ++i) {
+    FlightScope slow(id, i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::ifstream file("flight-recorder-test.0.json");
+  std::stringstream ss;
+  ss << file.rdbuf();
+  if (occurrences(ss.str(), "\"name\":\"slow\"") != 4) return TEST_FAILED;
+  // The trigger fires once.
+  if (std::ifstream("flight-recorder-test.1.json")) return TEST_FAILED;
+  std::remove("flight-recorder-test.0.json");
+  CHECK_FAILURE(std::invalid_argument, dumpFlightRecordWhenLonger(id, 0));
+  return TEST_SUCCEED;
+}
+
+int test_cost() {
+  static const ScopeId id("cost");
+  const int n = 1000000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; ++i) flightRecord(id, i);
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "flight record: " << elapsed.count() / n << " ns per event"
+            << std::endl;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_recording() == TEST_FAILED) return TEST_FAILED;
+  if (test_trigger() == TEST_FAILED) return TEST_FAILED;
+  if (test_cost() == TEST_FAILED) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+GENERATE_TEST()
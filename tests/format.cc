@@ -0,0 +1,94 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cmath>
+#include <hpp/util/debug.hh>
+#include <hpp/util/format.hh>
+#include <limits>
+
+#include "common.hh"
+#include "config.h"
+
+using hpp::debug::format::countFields;
+
+static_assert(countFields("no field") == 0, "");
+static_assert(countFields("{} and {:.3f}, {:x} {{}}") == 3, "");
+static_assert(countFields("{") == -1, "");
+static_assert(countFields("}") == -1, "");
+static_assert(countFields("{:.f}") == -1, "");
+static_assert(countFields("{:d}") == -1, "");
+
+#define CHECK_FORMAT(expected, ...)                         \
+  do {                                                      \
+    std::string str;                                        \
+    HPP_FORMAT_TO(str, __VA_ARGS__);                        \
+    if (str != expected) {                                  \
+      std::cerr << "got \"" << str << "\" instead of \""    \
+                << expected << '"' << std::endl;            \
+      return TEST_FAILED;                                   \
+    }                                                       \
+  } while (0)
+
+struct Point {
+  int x, y;
+};
+
+std::ostream& operator<<(std::ostream& os, const Point& p) {
+  return os << '(' << p.x << ", " << p.y << ')';
+}
+
+int run_test() {
+  CHECK_FORMAT("hello", "hello");
+  CHECK_FORMAT("{braces}", "{{braces}}");
+  CHECK_FORMAT("solved in 12 iterations, cost 0.125",
+               "solved in {} iterations, cost {:.3f}", 12, 0.125);
+  CHECK_FORMAT("-42 42 ff -10", "{} {} {:x} {:x}", -42, 42u, 255, -16);
+  CHECK_FORMAT("-9223372036854775808",
+               "{}", std::numeric_limits<long long>::min());
+  CHECK_FORMAT("0.1 1.5 1e+20", "{} {} {}", 0.1, 1.5f, 1e20);
+  CHECK_FORMAT("1.235e+03 2.50", "{:.3e} {:.2f}", 1234.6, 2.5);
+  CHECK_FORMAT("true x abc ab str", "{} {} {} {:.2} {}", true, 'x', "abc",
+               "abc", std::string("str"));
+  CHECK_FORMAT("p = (1, 2)", "p = {}", Point{1, 2});
+  CHECK_FORMAT("inf", "{}", std::numeric_limits<double>::infinity());
+
+  // Nested buffers do not share the thread buffer.
+  hpp::debug::format::Buffer outer;
+  HPP_FORMAT_TO(outer.str(), "outer {}", 1);
+  {
+    hpp::debug::format::Buffer inner;
+    HPP_FORMAT_TO(inner.str(), "inner {}", 2);
+    if (&inner.str() == &outer.str()) return TEST_FAILED;
+  }
+  if (outer.str() != "outer 1") return TEST_FAILED;
+
+  hppDoutf(info, "solved in {} iterations, cost {:.3f}", 12, 0.125);
+  hppDoutf(notice, "no argument");
+  return TEST_SUCCEED;
+}
+
+GENERATE_TEST()
@@ -0,0 +1,93 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cmath>
+#include <hpp/util/histogram.hh>
+#include <iostream>
+#include <stdexcept>
+
+#include "common.hh"
+#include "config.h"
+
+using hpp::debug::Histogram;
+
+int test_buckets() {
+  Histogram h(5, 40);
+  if (h.size() != 592) return TEST_FAILED;
+  // Buckets are contiguous and contain their upper bound.
+  for (std::size_t i = 0; i + 1 < h.size(); ++i) {
+    if (h.index(h.upperBound(i)) != i) return TEST_FAILED;
+    if (h.index(h.upperBound(i) + 1) != i + 1) return TEST_FAILED;
+  }
+  // Relative error is bounded.
+  for (std::uint64_t v = 1; v < (std::uint64_t(1) << 40); v = v * 3 + 1) {
+    double ub = (double)h.upperBound(h.index(v));
+    if (ub < (double)v || ub > (double)v * (1 + 1. / 16)) return TEST_FAILED;
+  }
+  // Values out of range go to the last bucket.
+  if (h.index(UINT64_MAX) != h.size() - 1) return TEST_FAILED;
+  Histogram full(16, 64);
+  if (full.upperBound(full.size() - 1) != UINT64_MAX) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_percentiles() {
+  Histogram h(7, 40);
+  if (h.percentile(50) != 0) return TEST_FAILED;
+  // 1 to 1000 microseconds.
+  for (int i = 1; i <= 1000; ++i) h.record(i * 1e-6);
+  if (h.count() != 1000) return TEST_FAILED;
+  const double p[] = {50, 90, 99, 99.9, 100};
+  for (double q : p) {
+    double expected = q * 1e-5;
+    if (std::abs(h.percentile(q) - expected) > expected / 60)
+      return TEST_FAILED;
+  }
+
+  Histogram other(7, 40);
+  for (int i = 0; i < 1000; ++i) other.record(2.);
+  h.merge(other);
+  if (h.count() != 2000) return TEST_FAILED;
+  if (h.percentile(40) > 1e-3) return TEST_FAILED;
+  if (std::abs(h.percentile(60) - 2.) > 2. / 60) return TEST_FAILED;
+  h.print(std::cout) << std::endl;
+
+  CHECK_FAILURE(std::invalid_argument, h.merge(Histogram(5, 40)));
+  CHECK_FAILURE(std::invalid_argument, Histogram(0, 40));
+  CHECK_FAILURE(std::invalid_argument, Histogram(8, 8));
+
+  h.reset();
+  if (h.count() != 0) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_buckets() != TEST_SUCCEED) return TEST_FAILED;
+  return test_percentiles();
+}
+
+GENERATE_TEST()
@@ -0,0 +1,135 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <chrono>
+#include <hpp/util/mutex.hh>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+// Lock the mutex from another thread, while it is held by the calling thread
+// for 10 ms.
+template <typename Mutex, typename Lock>
+void contend(Mutex& mutex, Lock lockFromThread) {
+  mutex.lock();
+  std::thread t(lockFromThread);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  mutex.unlock();
+  t.join();
+}
+
+int test_mutex() {
+  ProfiledMutex mutex("mutex");
+  for (int i = 0; i < 10; ++i) std::lock_guard<ProfiledMutex> lock(mutex);
+  const LockCounter& c = mutex.counter();
+  if (c.acquisitions() != 10 || c.contended() != 0) return TEST_FAILED;
+  if (c.percentile(99) != 0) return TEST_FAILED;
+
+  mutex.lock();
+  std::thread([&mutex]() {
+    if (mutex.try_lock()) mutex.unlock();
+  }).join();
+  mutex.unlock();
+  if (c.failedTries() != 1 || c.acquisitions() != 11) return TEST_FAILED;
+
+  contend(mutex, [&mutex]() { std::lock_guard<ProfiledMutex> lock(mutex); });
+  std::cout << c << std::endl;
+  if (c.acquisitions() != 13 || c.contended() != 1) return TEST_FAILED;
+  if (c.waitTime() < 5e-3) return TEST_FAILED;
+  // One acquisition out of 13 waited.
+  if (c.percentile(90) != 0 || c.percentile(99) < 5e-3) return TEST_FAILED;
+
+  // The counter is part of the global report.
+  std::ostringstream report;
+  dumpTimeCounters(report);
+  if (report.str().find("mutex") == std::string::npos) return TEST_FAILED;
+
+  mutex.counter().reset();
+  if (c.acquisitions() != 0 || c.contended() != 0) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_shared_mutex() {
+  ProfiledSharedMutex mutex("shared mutex");
+  const LockCounter& c = mutex.counter();
+  mutex.lock_shared();
+  std::thread([&mutex]() {
+    if (mutex.try_lock()) mutex.unlock();
+    std::shared_lock<ProfiledSharedMutex> lock(mutex);
+  }).join();
+  mutex.unlock_shared();
+  if (c.acquisitions() != 2 || c.sharedAcquisitions() != 2 ||
+      c.failedTries() != 1 || c.contended() != 0)
+    return TEST_FAILED;
+
+  contend(mutex, [&mutex]() {
+    std::shared_lock<ProfiledSharedMutex> lock(mutex);
+  });
+  std::cout << c << std::endl;
+  if (c.acquisitions() != 4 || c.sharedAcquisitions() != 3 ||
+      c.contended() != 1 || c.waitTime() < 5e-3)
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_shared_counter() {
+  LockCounter nodes("nodes");
+  {
+    ProfiledMutex a(nodes), b(nodes);
+    ProfiledSharedMutex c(nodes);
+    for (int i = 0; i < 5; ++i) {
+      std::lock_guard<ProfiledMutex> lockA(a), lockB(b);
+      std::shared_lock<ProfiledSharedMutex> lockC(c);
+    }
+    contend(a, [&a]() { std::lock_guard<ProfiledMutex> lock(a); });
+  }
+  if (nodes.acquisitions() != 17 || nodes.sharedAcquisitions() != 5 ||
+      nodes.contended() != 1)
+    return TEST_FAILED;
+
+  const unsigned long before = defaultLockCounter().acquisitions();
+  ProfiledMutex unnamed;
+  unnamed.lock();
+  unnamed.unlock();
+  if (&unnamed.counter() != &defaultLockCounter() ||
+      defaultLockCounter().acquisitions() != before + 1)
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_mutex() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_shared_counter() != TEST_SUCCEED) return TEST_FAILED;
+  return test_shared_mutex();
+}
+
+GENERATE_TEST()
@@ -0,0 +1,151 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#define HPP_ENABLE_BENCHMARK 1
+#include <hpp/util/profiler.hh>
+#include <hpp/util/timer.hh>
+
+#include "common.hh"
+#include "config.h"
+
+void projection() { HPP_PROFILE_SCOPE(projection); }
+
+void steering() {
+  HPP_PROFILE_SCOPE(steering);
+  projection();
+}
+
+void pathOptimization() {
+  HPP_PROFILE_SCOPE(pathOptimization);
+  for (int i = 0; i < 10; ++i) projection();
+  steering();
+}
+
+void spin(double seconds) {
+  volatile double d = 0;
+  hpp::debug::Timer timer(true);
+  do {
+    for (int i = 0; i < 1000; ++i) d += i;
+    timer.stop();
+  } while (timer.duration() < seconds);
+}
+
+void hot() {
+  HPP_PROFILE_SCOPE(hot);
+  spin(0.2);
+}
+
+void cold() {
+  HPP_PROFILE_SCOPE(cold);
+  spin(0.02);
+}
+
+int test_sampling() {
+  hpp::debug::resetProfile();
+  if (!hpp::debug::startSampling(1000)) {
+    std::cout << "Sampling profiler not supported." << std::endl;
+    return TEST_SUCCEED;
+  }
+  std::thread t(hot);
+  cold();
+  t.join();
+  hpp::debug::stopSampling();
+
+  std::stringstream text;
+  hpp::debug::printSamplingProfile(text);
+  std::cout << text.str() << std::endl;
+  const std::string report = text.str();
+  std::size_t h = report.find("\n    hot: "), c = report.find("\n    cold: ");
+  // The timer resolution may be coarser than requested, but the hot scope
+  // gets samples before the cold one.
+  if (h == std::string::npos || (c != std::string::npos && c < h))
+    return TEST_FAILED;
+  if (report.find("\n      at ") == std::string::npos) return TEST_FAILED;
+  hpp::debug::resetProfile();
+  std::stringstream empty;
+  hpp::debug::printSamplingProfile(empty);
+  if (empty.str() != "Sampling profile: 0 samples") return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_sampling() != TEST_SUCCEED) return TEST_FAILED;
+  std::thread t1(pathOptimization), t2(pathOptimization);
+  t1.join();
+  t2.join();
+  steering();
+  // The trees of the exited threads are reused, counts included.
+  hpp::debug::resetProfile();
+  for (int i = 0; i < 10; ++i) std::thread(pathOptimization).join();
+  {
+    std::stringstream text;
+    hpp::debug::printProfile(text);
+    if (text.str().find("\n  pathOptimization: 10 calls") == std::string::npos)
+      return TEST_FAILED;
+  }
+  hpp::debug::resetProfile();
+  std::thread t3(pathOptimization), t4(pathOptimization);
+  t3.join();
+  t4.join();
+  steering();
+
+  std::stringstream text;
+  hpp::debug::printProfile(text);
+  std::cout << text.str() << std::endl;
+  const std::string report = text.str();
+  const char* nodes[] = {"\n  pathOptimization: 2 calls",
+                         "\n    projection: 20 calls",
+                         "\n    steering: 2 calls",
+                         "\n      projection: 2 calls",
+                         "\n  steering: 1 calls",
+                         "\n    projection: 1 calls"};
+  for (const char* node : nodes)
+    if (report.find(node) == std::string::npos) return TEST_FAILED;
+
+  std::stringstream collapsed;
+  hpp::debug::printCollapsedProfile(collapsed);
+  std::cout << collapsed.str() << std::endl;
+  const char* stacks[] = {"pathOptimization ", "pathOptimization;projection ",
+                          "pathOptimization;steering;projection ",
+                          "steering;projection "};
+  for (const char* stack : stacks)
+    if (("\n" + collapsed.str()).find(std::string("\n") + stack) ==
+        std::string::npos)
+      return TEST_FAILED;
+
+  hpp::debug::resetProfile();
+  std::stringstream empty;
+  hpp::debug::printCollapsedProfile(empty);
+  if (!empty.str().empty()) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+GENERATE_TEST()
@@ -0,0 +1,169 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <hpp/util/budget.hh>
+#include <hpp/util/mutex.hh>
+#include <hpp/util/prometheus.hh>
+#include <hpp/util/timer.hh>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+typedef ConcurrentTimeCounter::duration_type duration_type;
+
+bool contains(const std::string& text, const std::string& line) {
+  return text.find(line + '\n') != std::string::npos;
+}
+
+int test_format() {
+  ConcurrentTimeCounter counter("solve");
+  counter.enableHistogram();
+  for (int i = 0; i < 3; ++i) counter.record(duration_type(1e-7));
+  for (int i = 0; i < 2; ++i) counter.record(duration_type(5e-4));
+  counter.record(duration_type(2));
+  TimeCounter other("quote\"d");
+  // Only one of the counters of this name has a histogram.
+  TimeCounter partial("partial");
+  ConcurrentTimeCounter partialWithHistogram("partial");
+  partialWithHistogram.enableHistogram();
+  partial.start();
+  partial.stop();
+  partialWithHistogram.record(duration_type(1e-7));
+  EventCounter checks("checks"), moreChecks("checks");
+  checks.increment(3);
+  moreChecks.increment();
+  Gauge nodes("nodes");
+  nodes.set(12.5);
+
+  std::ostringstream oss;
+  writeTimeCountersPrometheus(oss);
+  const std::string text = oss.str();
+  std::cout << text;
+  const char* expected[] = {
+      "# TYPE hpp_time_counter_seconds histogram",
+      "hpp_time_counter_seconds_bucket{name=\"solve\",le=\"1e-06\"} 3",
+      "hpp_time_counter_seconds_bucket{name=\"solve\",le=\"0.0001\"} 3",
+      "hpp_time_counter_seconds_bucket{name=\"solve\",le=\"0.001\"} 5",
+      "hpp_time_counter_seconds_bucket{name=\"solve\",le=\"1\"} 5",
+      "hpp_time_counter_seconds_bucket{name=\"solve\",le=\"10\"} 6",
+      "hpp_time_counter_seconds_bucket{name=\"solve\",le=\"+Inf\"} 6",
+      "hpp_time_counter_seconds_sum{name=\"solve\"} 2.0010003",
+      "hpp_time_counter_seconds_count{name=\"solve\"} 6",
+      "hpp_time_counter_seconds_count{name=\"quote\\\"d\"} 0",
+      "hpp_time_counter_seconds_bucket{name=\"partial\",le=\"+Inf\"} 2",
+      "hpp_time_counter_max_seconds{name=\"solve\"} 2",
+      "# TYPE hpp_event_count_total counter",
+      "hpp_event_count_total{name=\"checks\"} 4",
+      "# TYPE hpp_gauge gauge",
+      "hpp_gauge{name=\"nodes\"} 12.5"};
+  for (const char* line : expected)
+    if (!contains(text, line)) return TEST_FAILED;
+  // The counters without histogram have no bucket but +Inf.
+  if (text.find("name=\"quote\\\"d\",le=\"1e-06\"") != std::string::npos)
+    return TEST_FAILED;
+  if (text.find("name=\"partial\",le=\"1e-06\"") != std::string::npos)
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_exporter() {
+  const std::string path = "prometheus-test.prom";
+  std::remove(path.c_str());
+  CHECK_FAILURE(std::invalid_argument, PrometheusExporter(path, 0));
+
+  ConcurrentTimeCounter counter("exported");
+  {
+    PrometheusExporter exporter(path, 0.01);
+    for (int i = 0; i < 5; ++i) {
+      counter.record(duration_type(1e-3));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  std::ifstream in(path.c_str());
+  std::stringstream content;
+  content << in.rdbuf();
+  if (!contains(content.str(),
+                "hpp_time_counter_seconds_count{name=\"exported\"} 5"))
+    return TEST_FAILED;
+  if (std::ifstream((path + ".tmp").c_str())) return TEST_FAILED;
+  std::remove(path.c_str());
+
+  if (writeTimeCountersPrometheus("no-such-directory/metrics.prom"))
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+// Counters are created and destroyed while other threads read the registry.
+int test_churn() {
+  const std::string path = "prometheus-churn.prom";
+  std::atomic<bool> stop(false);
+  std::thread reader([&stop]() {
+    while (!stop.load()) {
+      snapshotTimeCounters();
+      forEachTimeCounter(
+          [](const TimeCounterBase& counter) { counter.copyHistogram(); });
+    }
+  });
+  {
+    PrometheusExporter exporter(path, 1e-4);
+    for (int i = 0; i < 2000; ++i) {
+      TimeCounter counter("churn");
+      counter.enableHistogram();
+      counter.start();
+      counter.stop();
+      ConcurrentTimeCounter concurrent("churn-concurrent");
+      concurrent.enableHistogram();
+      concurrent.record(duration_type(1e-3));
+      LockCounter lock("churn-lock");
+      lock.acquired();
+      BudgetCounter budget("churn-budget", 1);
+      budget.record(1e-3);
+    }
+  }
+  stop.store(true);
+  reader.join();
+  std::remove(path.c_str());
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_format() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_churn() != TEST_SUCCEED) return TEST_FAILED;
+  return test_exporter();
+}
+
+GENERATE_TEST()
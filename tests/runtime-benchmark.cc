@@ -0,0 +1,110 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#define HPP_ENABLE_RUNTIME_BENCHMARK 1
+#include <hpp/util/profiler.hh>
+#include <hpp/util/timer.hh>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+HPP_DEFINE_TIMECOUNTER(scoped);
+HPP_DEFINE_TIMECOUNTER(watch);
+HPP_DEFINE_CONCURRENT_TIMECOUNTER(concurrent);
+HPP_DEFINE_COUNTER(events);
+HPP_DEFINE_GAUGE(level);
+
+// The environment variable is read by the first query, even during the
+// static initialization, rather than when the library is loaded.
+bool enabledByEnvVar() {
+  setenv("HPP_LOGGINGLEVEL", "benchmark", 1);
+  return isBenchmarkEnabled();
+}
+const bool enabledAtStaticInitialization = enabledByEnvVar();
+
+void work() {
+  HPP_PROFILE_SCOPE(runtimeProfiled);
+  HPP_SCOPE_TIMECOUNTER(scoped);
+  HPP_SCOPE_TIMECOUNTER(concurrent);
+  hppStartBenchmark(benchmark);
+  hppStopBenchmark(benchmark);
+  hppDisplayBenchmark(benchmark);
+  HPP_INCREMENT_COUNTER(events);
+  HPP_ADD_GAUGE(level, 1);
+}
+
+std::string profile() {
+  std::ostringstream oss;
+  printProfile(oss);
+  return oss.str();
+}
+
+int run_test() {
+  if (!enabledAtStaticInitialization) return TEST_FAILED;
+  enableBenchmark(false);
+  for (int i = 0; i < 10; ++i) work();
+  HPP_START_TIMECOUNTER(watch);
+  if (HPP_STOP_TIMECOUNTER(watch) != 0) return TEST_FAILED;
+  if (_scoped_timecounter_.count() != 0 ||
+      _concurrent_timecounter_.count() != 0 ||
+      _watch_timecounter_.count() != 0)
+    return TEST_FAILED;
+  if (_events_counter_.value() != 0 || _level_gauge_.value() != 0)
+    return TEST_FAILED;
+  if (profile().find("runtimeProfiled") != std::string::npos)
+    return TEST_FAILED;
+
+  enableBenchmark(true);
+  for (int i = 0; i < 10; ++i) work();
+  if (_scoped_timecounter_.count() != 10 ||
+      _concurrent_timecounter_.count() != 10)
+    return TEST_FAILED;
+  if (_events_counter_.value() != 10 || _level_gauge_.value() != 10)
+    return TEST_FAILED;
+  if (profile().find("runtimeProfiled") == std::string::npos)
+    return TEST_FAILED;
+
+  // A watch started while enabled is stopped even if disabled in between,
+  // and a watch started while disabled is not stopped.
+  HPP_START_TIMECOUNTER(watch);
+  enableBenchmark(false);
+  HPP_STOP_TIMECOUNTER(watch);
+  enableBenchmark(true);
+  HPP_STOP_TIMECOUNTER(watch);
+  if (_watch_timecounter_.count() != 1 || _watch_timecounter_.isRunning())
+    return TEST_FAILED;
+  HPP_DISPLAY_TIMECOUNTER(watch);
+  return TEST_SUCCEED;
+}
+
+GENERATE_TEST()
@@ -0,0 +1,127 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cmath>
+#include <hpp/util/statistics.hh>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+bool near(double a, double b, double eps) { return std::fabs(a - b) <= eps; }
+
+int test_running() {
+  // Large offset: the naive sum of squares loses all precision.
+  RunningStatistics a, b, all;
+  const double offset = 1e9;
+  for (int i = 0; i < 1000; ++i) {
+    double x = offset + (i % 10);
+    (i < 300 ? a : b).record(x);
+    all.record(x);
+  }
+  // Variance of 0..9 repeated 100 times.
+  if (!near(all.mean(), offset + 4.5, 1e-6)) return TEST_FAILED;
+  if (!near(all.variance(), 8.25 * 1000 / 999, 1e-6)) return TEST_FAILED;
+  a.merge(b);
+  if (a.count() != 1000) return TEST_FAILED;
+  if (!near(a.mean(), all.mean(), 1e-6)) return TEST_FAILED;
+  if (!near(a.variance(), all.variance(), 1e-6)) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_ewma() {
+  ExponentialMovingAverage ewma(0.5);
+  ewma.record(4);
+  if (ewma.value() != 4) return TEST_FAILED;
+  ewma.record(8);
+  if (ewma.value() != 6) return TEST_FAILED;
+  try {
+    ExponentialMovingAverage invalid(0);
+    return TEST_FAILED;
+  } catch (const std::invalid_argument&) {
+  }
+  return TEST_SUCCEED;
+}
+
+int test_window() {
+  RollingWindow window(4);
+  for (int i = 1; i <= 10; ++i) window.record(i, i);
+  // Last 4 values: 7, 8, 9, 10.
+  RollingWindow::Summary s = window.summary(10);
+  if (s.count != 4 || s.min != 7 || s.max != 10 || s.mean != 8.5)
+    return TEST_FAILED;
+
+  RollingWindow timed(100, 2.5);
+  for (int i = 1; i <= 10; ++i) timed.record(i, i);
+  // Values recorded at times 7.5 and later: 8, 9, 10.
+  s = timed.summary(10);
+  if (s.count != 3 || s.min != 8 || s.max != 10) return TEST_FAILED;
+  if (!near(s.stddev, 1, 1e-12)) return TEST_FAILED;
+  s = timed.summary(100);
+  if (s.count != 0) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_median() {
+  if (median({}) != 0) return TEST_FAILED;
+  if (median({3, 1, 2}) != 2) return TEST_FAILED;
+  if (median({4, 1, 3, 2}) != 2.5) return TEST_FAILED;
+  // The outlier does not change the deviation.
+  std::vector<double> values = {1, 2, 3, 4, 5, 1000};
+  if (median(values) != 3.5) return TEST_FAILED;
+  if (medianAbsoluteDeviation(values) != 1.5) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_mann_whitney() {
+  // Same approximation as scipy.stats.mannwhitneyu(method="asymptotic").
+  MannWhitneyTest t = mannWhitneyU({1, 2, 3, 4, 5}, {6, 7, 8, 9, 10});
+  if (t.u != 0 || !near(t.pValue, 0.012185, 1e-5)) return TEST_FAILED;
+  t = mannWhitneyU({1, 2, 2, 3, 5, 8}, {2, 3, 4, 4, 6});
+  if (t.u != 11.5 || !near(t.pValue, 0.578657, 1e-5)) return TEST_FAILED;
+  t = mannWhitneyU({1, 1, 1}, {1, 1});
+  if (t.pValue != 1) return TEST_FAILED;
+  CHECK_FAILURE(std::invalid_argument, mannWhitneyU({}, {1}));
+
+  if (!near(normalQuantile(0.975), 1.959964, 1e-6)) return TEST_FAILED;
+  if (!near(normalQuantile(0.5), 0, 1e-12)) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int run_test() {
+  if (test_median() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_mann_whitney() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_running() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_ewma() != TEST_SUCCEED) return TEST_FAILED;
+  return test_window();
+}
+
+GENERATE_TEST()
@@ -26,7 +26,19 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
 // DAMAGE.
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "config.h"
 
@@ -46,10 +58,308 @@ void f(const int extra) {
 
 HPP_DEFINE_TIMECOUNTER(testCounter);
 HPP_DEFINE_TIMECOUNTER(testCounter2);
+HPP_DEFINE_CONCURRENT_TIMECOUNTER(concurrentCounter);
+HPP_DEFINE_COUNTER(testEvents);
+HPP_DEFINE_GAUGE(testGauge);
+
+int test_concurrent() {
+  const int nThreads = 4, N = 10000;
+  _concurrentCounter_timecounter_.enableHistogram();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nThreads; ++i)
+    threads.emplace_back([]() {
+      for (int j = 0; j < N; ++j) {
+        HPP_SCOPE_TIMECOUNTER(concurrentCounter);
+        f(0);
+      }
+    });
+  for (std::thread& t : threads) t.join();
+  HPP_DISPLAY_TIMECOUNTER(concurrentCounter);
+  if (_concurrentCounter_timecounter_.count() != nThreads * N)
+    return TEST_FAILED;
+  if (_concurrentCounter_timecounter_.min() >
+      _concurrentCounter_timecounter_.max())
+    return TEST_FAILED;
+  if (_concurrentCounter_timecounter_.histogram()->count() != nThreads * N)
+    return TEST_FAILED;
+  HPP_RESET_TIMECOUNTER(concurrentCounter);
+  if (_concurrentCounter_timecounter_.count() != 0) return TEST_FAILED;
+
+  // The counter may be a reference.
+  ConcurrentTimeCounter& _referenced_timecounter_ =
+      _concurrentCounter_timecounter_;
+  { HPP_SCOPE_TIMECOUNTER(referenced); }
+  if (_concurrentCounter_timecounter_.count() != 1) return TEST_FAILED;
+  HPP_RESET_TIMECOUNTER(concurrentCounter);
+  return TEST_SUCCEED;
+}
+
+int test_perf_counters() {
+  TimeCounter counter("perf");
+  counter.enablePerfCounters();
+  for (int i = 0; i < 10; ++i) {
+    TimeCounter::Scope scope(counter);
+    f(1);
+  }
+  std::cout << counter << std::endl;
+  // Unavailable counters must not prevent the time measurements.
+  if (counter.count() != 10) return TEST_FAILED;
+  double instructions = counter.perfCounter(PerfCounters::Instructions);
+  if (PerfCounters::isAvailable(PerfCounters::Instructions)) {
+    // f(1) performs a million iterations.
+    if (!(instructions > 1e6)) return TEST_FAILED;
+  } else if (!std::isnan(instructions))
+    return TEST_FAILED;
+  counter.reset();
+  if (!std::isnan(counter.perfCounter(PerfCounters::Instructions)))
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_cpu_usage() {
+  TimeCounter computing("computing"), sleeping("sleeping");
+  if (!std::isnan(computing.cpuRatio())) return TEST_FAILED;
+  computing.enableCpuUsage();
+  sleeping.enableCpuUsage();
+  for (int i = 0; i < 5; ++i) {
+    {
+      TimeCounter::Scope scope(computing);
+      f(1);
+    }
+    TimeCounter::Scope scope(sleeping);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::cout << computing << '\n' << sleeping << std::endl;
+  if (!(computing.cpuRatio() > 0.2 && computing.cpuRatio() < 1.5))
+    return TEST_FAILED;
+  if (!(sleeping.cpuRatio() < 0.2)) return TEST_FAILED;
+  // Each sleep is a voluntary context switch.
+  CpuUsage usage;
+  if (CpuUsage::read(usage) && sleeping.cpuUsage().voluntarySwitches < 5)
+    return TEST_FAILED;
+
+  Timer timer;
+  timer.enableCpuUsage();
+  timer.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  timer.stop();
+  timer.print(std::cout) << std::endl;
+  if (!(timer.cpuUsage().threadTime < timer.duration())) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_overhead() {
+  double overhead = timeCounterOverhead();
+  std::cout << "time counter overhead: " << overhead << std::endl;
+  if (!(overhead > 0 && overhead < 1e-5)) return TEST_FAILED;
+
+  TimeCounter raw("raw"), corrected("corrected");
+  corrected.subtractOverhead();
+  if (corrected.overhead() != overhead) return TEST_FAILED;
+  for (int i = 0; i < 1000; ++i) {
+    raw.start();
+    raw.stop();
+    corrected.start();
+    corrected.stop();
+  }
+  std::cout << raw << '\n' << corrected << std::endl;
+  if (corrected.min() < 0) return TEST_FAILED;
+  // The correction removes most of the time measured for an empty section.
+  if (!(corrected.min() < raw.min())) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_registry() {
+  {
+    TimeCounter local("local");
+    local.start();
+    local.stop();
+    std::vector<TimeCounterBase::Snapshot> snapshots = snapshotTimeCounters();
+    if (snapshots.size() != 4) return TEST_FAILED;
+    bool found = false;
+    for (const TimeCounterBase::Snapshot& s : snapshots)
+      if (s.name == "local") found = (s.count == 1);
+    if (!found) return TEST_FAILED;
+
+    std::ostringstream oss;
+    dumpTimeCounters(oss);
+    // Sorted by decreasing total time: testCounter2 spent the most.
+    std::string dump = oss.str();
+    if (dump.find("testCounter2") > dump.find("local")) return TEST_FAILED;
+    std::cout << dump;
+  }
+  if (snapshotTimeCounters().size() != 3) return TEST_FAILED;
+
+  resetTimeCounters();
+  for (const TimeCounterBase::Snapshot& s : snapshotTimeCounters())
+    if (s.count != 0 || s.totalTime != 0) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+// The thread safe counters are read while another thread measures, and the
+// others are skipped.
+int test_concurrent_snapshot() {
+  ConcurrentTimeCounter shared("snapshot-shared");
+  shared.enableHistogram();
+  std::atomic<bool> stop(false);
+  std::thread writer([&shared, &stop]() {
+    TimeCounter own("snapshot-own");
+    for (int i = 0; !stop.load(); ++i) {
+      if (i % 100 == 0) own.enableHistogram();
+      { TimeCounter::Scope scope(own); }
+      { ConcurrentTimeCounter::Scope scope(shared); }
+      if (i % 10 == 0) own.reset();
+    }
+  });
+  bool found = false;
+  for (int i = 0; i < 1000; ++i) {
+    for (const TimeCounterBase::Snapshot& s : snapshotTimeCounters(true)) {
+      if (s.name == "snapshot-own") found = true;
+    }
+    forEachTimeCounter(
+        [](const TimeCounterBase& counter) { counter.copyHistogram(); },
+        true);
+  }
+  stop = true;
+  writer.join();
+  if (found || shared.count() == 0) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+// The shards of the threads which exited are reused.
+int test_sharded() {
+  struct Shard {
+    Shard() : value(0) {}
+    std::atomic<int> value;
+  };
+  Sharded<Shard> sharded;
+  for (int i = 0; i < 10; ++i)
+    std::thread([&sharded]() { ++sharded.local().value; }).join();
+  int n = 0, sum = 0;
+  sharded.forEach([&n, &sum](const Shard& shard) {
+    ++n;
+    sum += shard.value;
+  });
+  if (n != 1 || sum != 10) return TEST_FAILED;
+
+  // The id of a destroyed object is reused, not the shards of its threads.
+  for (int i = 0; i < 100; ++i) {
+    Sharded<Shard> temporary;
+    if (temporary.local().value != 0) return TEST_FAILED;
+    temporary.local().value = 1;
+  }
+  return TEST_SUCCEED;
+}
+
+int test_metrics() {
+  const int nThreads = 4, N = 100000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nThreads; ++i)
+    threads.emplace_back([]() {
+      for (int j = 0; j < N; ++j) HPP_INCREMENT_COUNTER(testEvents);
+      HPP_ADD_GAUGE(testGauge, 0.5);
+    });
+  for (std::thread& t : threads) t.join();
+  if (_testEvents_counter_.value() != nThreads * N) return TEST_FAILED;
+  if (_testGauge_gauge_.value() != 0.5 * nThreads) return TEST_FAILED;
+  HPP_SET_GAUGE(testGauge, 42);
+
+  std::vector<MetricSnapshot> metrics = snapshotMetrics();
+  if (metrics.size() != 2 || !metrics[0].isCounter ||
+      metrics[0].value != nThreads * N || metrics[1].isCounter ||
+      metrics[1].value != 42)
+    return TEST_FAILED;
+  std::ostringstream oss;
+  dumpTimeCounters(oss);
+  std::cout << oss.str();
+  if (oss.str().find("testGauge") == std::string::npos) return TEST_FAILED;
+
+  // Gauges keep their value.
+  resetTimeCounters();
+  if (_testEvents_counter_.value() != 0 || _testGauge_gauge_.value() != 42)
+    return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+int test_merge() {
+  TimeCounter a("merged"), b("merged");
+  a.enableHistogram();
+  b.enableHistogram();
+  for (int i = 0; i < 10; ++i) {
+    a.start();
+    f(1);
+    a.stop();
+  }
+  for (int i = 0; i < 5; ++i) {
+    b.start();
+    f(3);
+    b.stop();
+  }
+  TimeCounter expected(a);
+  expected.merge(b);
+  if (expected.count() != 15) return TEST_FAILED;
+  if (expected.min() != a.min() || expected.max() != b.max())
+    return TEST_FAILED;
+  if (std::fabs(expected.totalTime() - a.totalTime() - b.totalTime()) > 1e-12)
+    return TEST_FAILED;
+  if (expected.histogram()->count() != 15) return TEST_FAILED;
+
+  // A histogram which would miss measurements is dropped.
+  {
+    TimeCounter empty("merge-partial"), plain("merge-partial");
+    empty.merge(b);
+    if (empty.histogram() == NULL) return TEST_FAILED;
+    plain.start();
+    plain.stop();
+    empty.merge(plain);
+    if (empty.count() != 6 || empty.histogram() != NULL) return TEST_FAILED;
+  }
+
+  // Save the counters of two processes and merge them.
+  const std::string path = "timer-test.counters";
+  if (!saveTimeCounters(path)) return TEST_FAILED;
+  std::vector<std::unique_ptr<TimeCounter>> loaded = loadTimeCounters(path);
+  std::remove(path.c_str());
+  TimeCounter merged("");
+  for (const std::unique_ptr<TimeCounter>& tc : loaded)
+    if (tc->name() == "merged") merged.merge(*tc);
+  // a, b and expected were saved.
+  TimeCounter twice(expected);
+  twice.merge(expected);
+  if (merged.count() != twice.count()) return TEST_FAILED;
+  if (merged.min() != twice.min() || merged.max() != twice.max())
+    return TEST_FAILED;
+  if (std::fabs(merged.variance() / twice.variance() - 1) > 1e-9)
+    return TEST_FAILED;
+  if (merged.percentile(50) != twice.percentile(50)) return TEST_FAILED;
+  std::cout << merged << std::endl;
+
+  CHECK_FAILURE(std::runtime_error, loadTimeCounters("no-such-file"));
+
+  // Corrupt the range of the histograms, which are saved with a precision
+  // of 5 and a range of 40.
+  if (!saveTimeCounters(path)) return TEST_FAILED;
+  std::string bytes;
+  {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in),
+                 std::istreambuf_iterator<char>());
+  }
+  const std::string range("\x05\0\0\0\x28\0\0\0", 8);
+  std::size_t pos = bytes.find(range);
+  if (pos == std::string::npos) return TEST_FAILED;
+  bytes[pos + 4] = 2;
+  std::ofstream(path.c_str(), std::ios::binary) << bytes;
+  CHECK_FAILURE(std::runtime_error, loadTimeCounters(path));
+  std::remove(path.c_str());
+  return TEST_SUCCEED;
+}
 
 int run_test() {
   int N = 10;
-  logging.benchmark = Channel("BENCHMARK", {&logging.console});
+  logging().benchmark = Channel("BENCHMARK", {&logging().console});
+  _testCounter2_timecounter_.enableHistogram();
+  _testCounter2_timecounter_.enableWindow(5);
   for (int i = 0; i < N; ++i) {
     HPP_START_TIMECOUNTER(testCounter);
     int k = 1 + (std::rand() % 10);
@@ -67,7 +377,17 @@ int run_test() {
     HPP_DISPLAY_LAST_TIMECOUNTER(testCounter2);
   }
   HPP_DISPLAY_TIMECOUNTER(testCounter2);
-  return 0;
+  if (_testCounter2_timecounter_.window().count != 5) return TEST_FAILED;
+  if (!(_testCounter2_timecounter_.stddev() > 0)) return TEST_FAILED;
+  if (test_concurrent() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_perf_counters() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_cpu_usage() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_overhead() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_registry() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_concurrent_snapshot() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_sharded() != TEST_SUCCEED) return TEST_FAILED;
+  if (test_metrics() != TEST_SUCCEED) return TEST_FAILED;
+  return test_merge();
 }
 
 GENERATE_TEST()
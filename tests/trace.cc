@@ -0,0 +1,138 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#define HPP_ENABLE_BENCHMARK 1
+#include <hpp/util/profiler.hh>
+#include <hpp/util/timer.hh>
+#include <hpp/util/trace.hh>
+
+#include "common.hh"
+#include "config.h"
+
+using namespace hpp::debug;
+
+HPP_DEFINE_TIMECOUNTER(counter);
+HPP_DEFINE_CONCURRENT_TIMECOUNTER(concurrentCounter);
+
+void work() {
+  for (int i = 0; i < 100; ++i) {
+    HPP_PROFILE_SCOPE(outer);
+    HPP_SCOPE_TIMECOUNTER(concurrentCounter);
+  }
+}
+
+std::size_t occurrences(const std::string& str, const std::string& pattern) {
+  std::size_t n = 0;
+  for (std::size_t pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1))
+    ++n;
+  return n;
+}
+
+int run_test() {
+  work();
+  std::stringstream empty;
+  writeTrace(empty);
+  if (occurrences(empty.str(), "\"ph\"") != 0) return TEST_FAILED;
+
+  enableTrace(true);
+  {
+    HPP_SCOPE_TIMECOUNTER(counter);
+    hppStartBenchmark(benchmark);
+    std::thread t1(work), t2(work);
+    t1.join();
+    t2.join();
+    hppStopBenchmark(benchmark);
+  }
+  {
+    TraceScope scope("a \"quoted\" name");
+    enableTrace(false);
+  }
+  TraceScope untraced("untraced");
+
+  std::stringstream ss;
+  writeTrace(ss);
+  const std::string trace = ss.str();
+  if (occurrences(trace, "\"ph\":\"B\"") != 403) return TEST_FAILED;
+  if (occurrences(trace, "\"ph\":\"E\"") != 403) return TEST_FAILED;
+  if (occurrences(trace, "\"name\":\"concurrentCounter\"") != 400)
+    return TEST_FAILED;
+  if (occurrences(trace, "\"name\":\"benchmark\"") != 2) return TEST_FAILED;
+  if (occurrences(trace, "a \\\"quoted\\\" name") != 2) return TEST_FAILED;
+  if (occurrences(trace, "untraced") != 0) return TEST_FAILED;
+
+  // The names of the events outlive the counters.
+  clearTrace();
+  enableTrace(true);
+  {
+    std::unique_ptr<TimeCounter> temporary(
+        new TimeCounter(std::string("temporary") + " counter"));
+    TimeCounter::Scope scope(*temporary);
+  }
+  {
+    TimeCounter renamed("before renaming");
+    { TimeCounter::Scope scope(renamed); }
+    renamed = TimeCounter("after renaming");
+  }
+  enableTrace(false);
+  std::stringstream names;
+  writeTrace(names);
+  if (occurrences(names.str(), "\"name\":\"temporary counter\"") != 2)
+    return TEST_FAILED;
+  if (occurrences(names.str(), "\"name\":\"before renaming\"") != 2)
+    return TEST_FAILED;
+
+  // Chunks released by clearTrace are reused.
+  for (int round = 0; round < 2; ++round) {
+    clearTrace();
+    enableTrace(true);
+    for (int i = 0; i < 50; ++i) work();
+    enableTrace(false);
+    std::stringstream chunks;
+    writeTrace(chunks);
+    if (occurrences(chunks.str(), "\"ph\"") != 50 * 400) return TEST_FAILED;
+  }
+
+  // The capacity is rounded up to the size of a chunk of events.
+  clearTrace();
+  setTraceCapacity(10);
+  enableTrace(true);
+  for (int i = 0; i < 20; ++i) work();
+  enableTrace(false);
+  std::stringstream limited;
+  writeTrace(limited);
+  if (occurrences(limited.str(), "\"ph\"") != 4096 + 1) return TEST_FAILED;
+  if (occurrences(limited.str(), "dropped events") != 1) return TEST_FAILED;
+  return TEST_SUCCEED;
+}
+
+GENERATE_TEST()